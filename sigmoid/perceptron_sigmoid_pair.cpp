@@ -45,6 +45,43 @@
 #include <utility>
 #include <cstdlib>
 #include <ctime>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <array>
+#include <limits>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <iterator>
+#include <cerrno>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#define PERCEPTRON_HAS_MMAP 1
+#define PERCEPTRON_HAS_SOCKETS 1
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PERCEPTRON_X86_SIMD 1
+#endif
 
 using std::vector;
 using std::string;
@@ -60,8 +97,6 @@ using std::uniform_real_distribution;
 using std::exp;
 using std::round;
 using std::pair;
-using std::srand;
-using std::rand;
 
 const int COLUMNS_NUM = 10;
 const int ROWS_NUM = 16;
@@ -70,498 +105,6459 @@ const int RANDOM_STATE = 42;
 const float MIN_WEIGHT_VALUE = -1.0;
 const float MAX_WEIGHT_VALUE = 1.0;
 const float LEARNING_RATE = 0.05;
-const int ITERATION_NUMBER = 2500;
+const int EPOCHS_NUM = 20;
+const int BATCH_SIZE = 1;
+const int CLASSES_NUM = 5;
+const int PIXELS_NUM = ROWS_NUM * COLUMNS_NUM;
+const float MIN_OUTPUT = 0.15;
+const int SIMD_LANES = 8;
 mt19937 generator(RANDOM_STATE);
 uniform_real_distribution<> dist(MIN_WEIGHT_VALUE, MAX_WEIGHT_VALUE);
 
 /**
- * @brief Clase FileManager que se encarga de manejar la apertura, lectura y escritura de archivos .txt.  
+ * Contador de reservas de memoria dinámica del programa. Lo incrementa el operador new reemplazado a 
+ * continuación y lo consulta el modo de medición (--bench) para verificar cuántas reservas hace el 
+ * reconocimiento por cada caracter. El reemplazo solo se compila con -DPERCEPTRON_COUNT_ALLOCATIONS, para que el 
+ * resto de los modos no pague una operación atómica por cada reserva; sin esa bandera el contador queda en cero.
 */
-class FileManager {
-    public:
-        fstream file;
-        string mode;
-        string filename;
+std::atomic<unsigned long long> allocationCount(0);
 
-        /**
-         * @brief Constructor de la clase FileManager.
-         * 
-         * @param aFilename Parámetro de tipo cadena de caracteres que representa el nombre del archivo. 
-         * @param aMode Parámetro de tipo cadena de caracteres que representa el modo de apertura del 
-         * archivo (lectura o escritura).
-        */
-        FileManager(string aFilename, string aMode) {
-            filename = aFilename;
-            mode = aMode;
-            get_file();
-        };
+#if defined(PERCEPTRON_COUNT_ALLOCATIONS)
+const bool COUNTING_ALLOCATIONS = true;
 
-        /**
-         * @brief Método utilizado para parsear una matriz de números de coma flotante dentro de un archivo 
-         * .txt.
-         * 
-         * @return Vector de vectores de números de coma flotante (matriz de números reales).
-        */
-        vector<vector<float>> parse_float_matrix() {
-            vector<vector<float>> matrix;
-            string str_line;
-            for(int i = 0; i < 16; i++) {
-                getline(file, str_line);
-                vector<float> row = {};
-                istringstream iss(str_line);
-                string token;
+void *operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    void *pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    };
+    return pointer;
+};
 
-                while (iss >> token) {
-                    row.push_back(stof(token));
-                };
+// Se declaran fuera de línea para que el compilador no empareje el free con el new de cada llamada.
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+};
 
-                matrix.push_back(row);
-            }
-            return matrix;
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+void operator delete(void *pointer, std::size_t) noexcept {
+    ::operator delete(pointer);
+};
+#else
+const bool COUNTING_ALLOCATIONS = false;
+#endif
+
+/**
+ * @brief Función que devuelve la posición del bit encendido menos significativo de una palabra no nula.
+*/
+inline int lowest_bit(uint32_t word) {
+#if defined(__GNUC__)
+    return __builtin_ctz(word);
+#else
+    int position = 0;
+    while ((word & 1u) == 0) {
+        word >>= 1;
+        position++;
+    };
+    return position;
+#endif
+};
+
+/**
+ * @brief Función que cuenta los bits encendidos de una palabra.
+*/
+inline int count_bits(uint32_t word) {
+#if defined(__GNUC__)
+    return __builtin_popcount(word);
+#else
+    int total = 0;
+    while (word != 0) {
+        word &= word - 1;
+        total++;
+    };
+    return total;
+#endif
+};
+
+// MÉTRICAS
+
+/**
+ * Instrumentación del programa: contadores, cronómetros por fase e histograma de la salida ganadora. Solo se 
+ * compila con -DPERCEPTRON_METRICS; sin esa bandera las macros METRIC_* no generan código y el reconocimiento no 
+ * cambia en nada. Cada hilo escribe en su propia ranura (MetricsSlot) sin cerrojos ni instrucciones atómicas de 
+ * lectura-modificación-escritura; solo quien lee el total recorre las ranuras.
+ * 
+ * Los caracteres reconocidos se cuentan en resolve_batch de cada red y en BasicRecognitionCache, que son los 
+ * caminos por los que se sirven. Las comprobaciones internas (aciertos del entrenamiento, aprendizaje en línea, 
+ * validación de las redes cuantizadas) usan resolve, que no se cuenta.
+*/
+enum MetricCounter {
+    COUNTER_GLYPHS_RECOGNIZED,
+    COUNTER_GLYPHS_REJECTED,
+    COUNTER_TRAINING_PATTERNS,
+    COUNTER_TRAINING_ERRORS,
+    COUNTER_TRAINING_UPDATES,
+    COUNTER_KNOWLEDGE_BASE_LOADS,
+    COUNTERS_NUM
+};
+
+enum MetricTimer {
+    TIMER_KNOWLEDGE_BASE,
+    TIMER_READ_GLYPHS,
+    TIMER_PROCESS_INPUT,
+    TIMER_COMPETITION,
+    TIMER_RESOLVE_BATCH,
+    TIMER_TRAINING_EPOCH,
+    TIMER_TRAINING_BATCH,
+    TIMERS_NUM
+};
+
+const char *const COUNTER_NAMES[COUNTERS_NUM] = {"glyphs_recognized", "glyphs_rejected", "training_patterns",
+                                                 "training_errors", "training_updates", "knowledge_base_loads"};
+const char *const TIMER_NAMES[TIMERS_NUM] = {"knowledge_base", "read_glyphs", "process_input", "competition",
+                                             "resolve_batch", "training_epoch", "training_batch"};
+// Cubeta k de un cronómetro: duraciones menores que 2^k ns (la última acumula el resto)
+const int LATENCY_BUCKETS = 32;
+// Cubeta k del histograma de salidas: [k / SCORE_BUCKETS, (k + 1) / SCORE_BUCKETS)
+const int SCORE_BUCKETS = 20;
+
+/**
+ * @brief Función que devuelve el número de bits necesarios para representar un valor (0 para el 0).
+*/
+inline int bit_length(uint64_t value) {
+#if defined(__GNUC__)
+    return value == 0 ? 0 : 64 - __builtin_clzll(value);
+#else
+    int length = 0;
+    while (value != 0) {
+        value >>= 1;
+        length++;
+    };
+    return length;
+#endif
+};
+
+/**
+ * @brief Totales de todas las ranuras en un momento dado (ver MetricsRegistry::totals).
+*/
+struct MetricsTotals {
+    uint64_t counters[COUNTERS_NUM];
+    uint64_t timerCounts[TIMERS_NUM];
+    uint64_t timerNanoseconds[TIMERS_NUM];
+    uint64_t timerBuckets[TIMERS_NUM][LATENCY_BUCKETS];
+    uint64_t scoreBuckets[SCORE_BUCKETS];
+    // Suma de las salidas ganadoras, en millonésimas
+    uint64_t scoreMicros;
+};
+
+/**
+ * @brief Ranura de métricas de un hilo. Solo la escribe su hilo, así que cada suma es una lectura y una escritura 
+ * relajadas; son atómicas únicamente para que otro hilo pueda leerlas mientras tanto.
+*/
+struct alignas(64) MetricsSlot {
+    std::atomic<uint64_t> counters[COUNTERS_NUM];
+    std::atomic<uint64_t> timerCounts[TIMERS_NUM];
+    std::atomic<uint64_t> timerNanoseconds[TIMERS_NUM];
+    std::atomic<uint64_t> timerBuckets[TIMERS_NUM][LATENCY_BUCKETS];
+    std::atomic<uint64_t> scoreBuckets[SCORE_BUCKETS];
+    std::atomic<uint64_t> scoreMicros;
+
+    MetricsSlot() {
+        for (int c = 0; c < COUNTERS_NUM; c++) {
+            counters[c].store(0, std::memory_order_relaxed);
         };
+        for (int t = 0; t < TIMERS_NUM; t++) {
+            timerCounts[t].store(0, std::memory_order_relaxed);
+            timerNanoseconds[t].store(0, std::memory_order_relaxed);
+            for (int b = 0; b < LATENCY_BUCKETS; b++) {
+                timerBuckets[t][b].store(0, std::memory_order_relaxed);
+            };
+        };
+        for (int b = 0; b < SCORE_BUCKETS; b++) {
+            scoreBuckets[b].store(0, std::memory_order_relaxed);
+        };
+        scoreMicros.store(0, std::memory_order_relaxed);
+    };
 
-        /**
-         * @brief Método utilizado para parsear una matriz de números enteros dentro de un archivo .txt.
-         * 
-         * @return Vector de vectores de números enteros (matriz de números enteros).
-        */
-        vector<vector<int>> parse_integer_matrix() {
-            vector<vector<int>> matrix;
-            string str_line;
-            for(int i = 0; i < 16; i++) {
-                getline(file, str_line);
-                vector<int> row = {};
-                istringstream iss(str_line);
-                string token;
+    static void add(std::atomic<uint64_t> &value, uint64_t amount) {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    };
+};
 
-                while (iss >> token) {
-                    row.push_back(stoi(token));
-                };
+/**
+ * @brief Clase MetricsRegistry que reparte una ranura a cada hilo y suma todas al leer los totales. La ranura de un 
+ * hilo que termina se guarda con sus valores para el siguiente hilo que se cree, así que los totales nunca 
+ * retroceden y el número de ranuras no pasa del máximo de hilos vivos a la vez.
+*/
+class MetricsRegistry {
+    public:
+        std::mutex mutex;
+        std::deque<MetricsSlot> slots;
+        vector<MetricsSlot *> freeSlots;
+        std::chrono::steady_clock::time_point start;
 
-                matrix.push_back(row);
-            }
-            return matrix;
+        MetricsRegistry() {
+            start = std::chrono::steady_clock::now();
         };
 
         /**
-         * @brief Método utilizado para parsear un número de coma flotante dentro de un archivo .txt.
-         * 
-         * @return Número de coma flotante (número real).
+         * @brief Método utilizado para obtener la ranura del hilo actual (se asigna en su primera métrica).
         */
-        float parse_float() {
-            float number;
-            string str_line;
-            getline(file, str_line);
-            number = stof(str_line);
+        MetricsSlot &local() {
+            struct Owner {
+                MetricsRegistry *registry = nullptr;
+                MetricsSlot *slot = nullptr;
 
-            return number;
-        }
+                ~Owner() {
+                    if (slot != nullptr) {
+                        std::lock_guard<std::mutex> lock(registry->mutex);
+                        registry->freeSlots.push_back(slot);
+                    };
+                };
+            };
+            static thread_local Owner owner;
+            if (owner.slot == nullptr) {
+                std::lock_guard<std::mutex> lock(mutex);
+                owner.registry = this;
+                if (!freeSlots.empty()) {
+                    owner.slot = freeSlots.back();
+                    freeSlots.pop_back();
+                } else {
+                    owner.slot = &slots.emplace_back();
+                };
+            };
+            return *owner.slot;
+        };
 
-        // Extras
+        void add(MetricCounter counter, uint64_t amount) {
+            MetricsSlot::add(local().counters[counter], amount);
+        };
 
-        /**
-         * @brief Método utilizado para obtener el archivo .txt en el modo especificado por la clase.
-        */
-        void get_file() {
-            if (mode == "write") {
-                file.open(filename, std::ios::out);
-            } else {
-                file.open(filename, std::ios::in);
-            }
-            
+        void record(MetricTimer timer, uint64_t nanoseconds) {
+            MetricsSlot &slot = local();
+            MetricsSlot::add(slot.timerCounts[timer], 1);
+            MetricsSlot::add(slot.timerNanoseconds[timer], nanoseconds);
+            MetricsSlot::add(slot.timerBuckets[timer][std::min(bit_length(nanoseconds), LATENCY_BUCKETS - 1)], 1);
         };
 
         /**
-         * @brief Método utilizado para escribir en el archivo .txt dado por la clase.
+         * @brief Método utilizado para registrar la respuesta de un caracter reconocido.
+         * 
+         * @param scores Parámetro de tipo arreglo con las salidas sigmoide de cada neurona (nullptr si la red no las 
+         * calcula; entonces solo se cuentan el caracter y el rechazo).
+         * @param classes Parámetro de tipo entero con el número de salidas.
+         * @param answer Parámetro de tipo entero con la respuesta de la competencia (-1 = rechazo).
         */
-        void write(string words) {
-            file << words;
+        void recognized(const float *scores, int classes, int answer) {
+            MetricsSlot &slot = local();
+            MetricsSlot::add(slot.counters[COUNTER_GLYPHS_RECOGNIZED], 1);
+            MetricsSlot::add(slot.counters[COUNTER_GLYPHS_REJECTED], answer < 0);
+            if (scores != nullptr) {
+                float best = *std::max_element(scores, scores + classes);
+                best = std::min(std::max(best, 0.0f), 1.0f);
+                MetricsSlot::add(slot.scoreBuckets[std::min(static_cast<int>(best * SCORE_BUCKETS), SCORE_BUCKETS - 1)], 1);
+                MetricsSlot::add(slot.scoreMicros, static_cast<uint64_t>(best * 1e6f));
+            };
         };
 
         /**
-         * @brief Método utilizado para saltar de línea en el archivo .txt dado por la clase.
+         * @brief Método utilizado para sumar todas las ranuras.
         */
-        void line_break() {
-            string str_line;
-            getline(file, str_line);
-        }
+        MetricsTotals totals() {
+            MetricsTotals result = {};
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const MetricsSlot &slot : slots) {
+                for (int c = 0; c < COUNTERS_NUM; c++) {
+                    result.counters[c] += slot.counters[c].load(std::memory_order_relaxed);
+                };
+                for (int t = 0; t < TIMERS_NUM; t++) {
+                    result.timerCounts[t] += slot.timerCounts[t].load(std::memory_order_relaxed);
+                    result.timerNanoseconds[t] += slot.timerNanoseconds[t].load(std::memory_order_relaxed);
+                    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+                        result.timerBuckets[t][b] += slot.timerBuckets[t][b].load(std::memory_order_relaxed);
+                    };
+                };
+                for (int b = 0; b < SCORE_BUCKETS; b++) {
+                    result.scoreBuckets[b] += slot.scoreBuckets[b].load(std::memory_order_relaxed);
+                };
+                result.scoreMicros += slot.scoreMicros.load(std::memory_order_relaxed);
+            };
+            return result;
+        };
+
+        double uptime() const {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        };
 };
 
+MetricsRegistry metrics;
+
 /**
- * @brief Clase Perceptron que modela la neurona propuesta por Frank Rosenblatt.
- * 
- * Se utiliza como una neuorna individual en una red neuronal. Posee N número de entradas (dendritas), con
- * sus respectivos pesos, una razón de aprendizaje, la sumatoria ponderada y una función de activación.   
+ * @brief Clase ScopedTimer que mide la duración de un bloque y la registra al salir de él.
 */
-class Perceptron {
+class ScopedTimer {
     public:
-        int randomState;
-        float bias;
-        vector<vector<float>> weights;
-        float learningRate;
+        MetricTimer timer;
+        std::chrono::steady_clock::time_point start;
 
-        /**
-         * @brief Constructor de la clase Perceptron.
-         * 
-         * @param aLearningRate Parámetro de tipo flotante necesario para otorgar la razón de aprendizaje de la neurona. 
-         * @param aRandomState Parámetro de tipo entero necesario para otorgar la semilla de aleatoriedad para generar 
-         * los pesos de la neurona.
-        */
-        Perceptron(float aLearningRate, int aRandomState) {
-            learningRate = aLearningRate;
-            randomState = aRandomState;
-            initialize_bias();
-            initialize_weights();
+        ScopedTimer(MetricTimer aTimer) {
+            timer = aTimer;
+            start = std::chrono::steady_clock::now();
         };
 
-        /**
-         * @brief Método utilizado para calcular la suma ponderada en base a las entradas y los pesos de la neurona. 
-         * Se utiliza un producto punto entre el vector de entradas y el vector de pesos y, al final, se le suma el
-         * sesgo (o bias). Fórmula: sum(x * w) + bias
-         * 
-         * @param inputValues Parámetro de tipo vector de vectores de enteros (matriz de enteros) que hace referencia 
-         * a los valores de entrada de la neurona.
-         * 
-         * @return Número de coma flotante (resultado de la suma ponderada).
-        */
-        float net_input(vector<vector<int>> inputValues) {
-            float result = 0;
-            for (int i = 0; i < ROWS_NUM; i++) {
-                for (int j = 0; j < COLUMNS_NUM; j++) {
-                    result += inputValues[i][j] * weights[i][j];
-                }
-            }
-            return result + bias;
+        ~ScopedTimer() {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            metrics.record(timer, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
         };
+};
+
+#if defined(PERCEPTRON_METRICS)
+#define METRIC_ADD(counter, amount) metrics.add(counter, amount)
+#define METRIC_TIMER(timer) ScopedTimer scopedTimer(timer)
+#define METRIC_RECOGNIZED(scores, classes, answer) metrics.recognized(scores, classes, answer)
+#else
+#define METRIC_ADD(counter, amount) ((void) 0)
+#define METRIC_TIMER(timer) ((void) 0)
+#define METRIC_RECOGNIZED(scores, classes, answer) ((void) 0)
+#endif
+
+/**
+ * @brief Clase BasicGlyph que representa una matriz binaria de Rows x Columns (el caracter a analizar).
+ *
+ * Cada píxel ocupa un bit dentro de un arreglo fijo de palabras, así que la matriz 16x10 cabe en 20 bytes,
+ * se copia sin reservar memoria dinámica y la suma ponderada solo recorre los píxeles encendidos. Las dimensiones 
+ * son parámetros de plantilla, por lo que todos los recorridos tienen límites conocidos al compilar.
+*/
+template <int Rows, int Columns>
+class BasicGlyph {
+    public:
+        static constexpr int ROWS = Rows;
+        static constexpr int COLUMNS = Columns;
+        static constexpr int PIXELS = Rows * Columns;
+        static constexpr int WORDS = (PIXELS + 31) / 32;
+
+        uint32_t words[WORDS];
 
         /**
-         * @brief Método utilizado para describir la función de activación de la neurona (función sigmoide). 
-         * Se utiliza para determinar si las entradas son capaces de activar (excitar) o no (inhibir) a la neurona.
-         * 
-         * @param inputValues Parámetro de tipo vector de vectores de enteros (matriz de enteros) que hace referencia 
-         * a los valores de entrada de la neurona.
-         * 
-         * @return Número de coma flotante (salida de la función sigmoide evaluada en el resultado de la suma ponderada).
+         * @brief Constructor de la clase BasicGlyph. Inicializa todos los píxeles apagados.
         */
-        float activation_function(vector<vector<int>> inputValues) {
-            float weightedSum = net_input(inputValues);
-            return 1 / (1 + exp(-weightedSum));
+        BasicGlyph() {
+            clear();
         };
 
-        // AJUSTES DE LA NEURONA
-
         /**
-         * @brief Método utilizado para ajustar los pesos del perceptron (neuorna) a través de la Regla Delta. 
-         * Fórmula: w + L(s - y)x
-         * 
-         * @param inputValues Parámetro de tipo vector de vectores de enteros (matriz de enteros) que hace referencia 
-         * a los valores de entrada de la neurona.
-         * @param expectedValue Parámetro de tipo entero que hace referencia al valor esperado en la salida de
-         * la neurona.
-         * @param outputValue Parámetro de tipo número de coma flotante que hace referencia al valor obtenido 
-         * en la salida de la neurona.
+         * @brief Método utilizado para consultar el píxel ubicado en la posición lineal dada (fila * Columns + columna).
         */
-        void adjust_weights(vector<vector<int>> inputValues, int expectedValue, int outputValue) {
-            for (int i = 0; i < ROWS_NUM; i++) {
-                for (int j = 0; j < COLUMNS_NUM; j++) {
-                    weights[i][j] += learningRate * (expectedValue - outputValue) * inputValues[i][j];
-                };
-            };
+        bool test(int index) const {
+            return (words[index / 32] >> (index % 32)) & 1u;
         };
 
         /**
-         * @brief Método utilizado para ajustar el sesgo (o bias) del perceptron (neuorna) a través de la Regla Delta. 
-         * Fórmula: b + L(s - y)1
-         * 
-         * @param expectedValue Parámetro de tipo entero que hace referencia al valor esperado en la salida de
-         * la neurona.
-         * @param outputValue Parámetro de tipo número de coma flotante que hace referencia al valor obtenido 
-         * en la salida de la neurona.
+         * @brief Método utilizado para consultar el píxel ubicado en la fila y columna dadas.
         */
-        void adjust_bias(int expectedValue, int outputValue) {
-            bias += learningRate * (expectedValue - outputValue) * 1;
+        bool get(int row, int column) const {
+            return test(row * Columns + column);
         };
 
-        // MÉTODOS DE UTILIDAD DEL PERCEPTRON
-
         /**
-         * @brief Método utilizado para inicializar el vector de pesos de la neurona aleatoriamente.
+         * @brief Método utilizado para encender o apagar el píxel ubicado en la fila y columna dadas.
         */
-        void initialize_weights() {
-            for (int i = 0; i < ROWS_NUM; i++) {
-                vector<float> new_row = {};
-                for (int i = 0; i < COLUMNS_NUM; i++) {
-                    new_row.push_back(dist(generator));
-                };
-                weights.push_back(new_row);
-            };
+        void set(int row, int column, bool value) {
+            int index = row * Columns + column;
+            uint32_t mask = 1u << (index % 32);
+            if (value) {
+                words[index / 32] |= mask;
+            } else {
+                words[index / 32] &= ~mask;
+            }
         };
 
         /**
-         * @brief Método utilizado para inicializar el valor del bias (o sesgo ) de la neurona aleatoriamente.
+         * @brief Método utilizado para apagar todos los píxeles.
         */
-        void initialize_bias() {
-            bias = dist(generator);
+        void clear() {
+            for (int w = 0; w < WORDS; w++) {
+                words[w] = 0;
+            };
         };
 
         /**
-         * @brief Método utilizado para mostrar el vector de pesos de la neurona en la consola.
+         * @brief Método utilizado para contar los píxeles encendidos.
+         *
+         * @return Número entero (cantidad de píxeles encendidos).
         */
-        void show_weights() {
-            for (vector<float> weight : weights) {
-                for (float w : weight) {
-                    cout << w << ", ";
-                };
-                cout << "\n";
+        int count() const {
+            int total = 0;
+            for (int w = 0; w < WORDS; w++) {
+                total += count_bits(words[w]);
             };
+            return total;
         };
 
         /**
-         * @brief Método utilizado para retornar el vector de pesos de la neurona en una cadena de caracteres.
-         * 
-         * @return Cadena de caracteres que representan la matriz de pesos y el bias (o sesgo) de la neurona.
+         * @brief Método utilizado para recorrer, en orden creciente, la posición lineal de cada píxel encendido.
+         *
+         * @param visit Función que recibe la posición lineal (fila * Columns + columna) del píxel.
         */
-        string weights_to_string() {
-            string result = "";
-            for (vector<float> weight : weights) {
-                string row = "";
-                for (float w : weight) {
-                    row += to_string(w) + " ";
+        template <typename Visitor>
+        void for_each_active(Visitor visit) const {
+            for (int w = 0; w < WORDS; w++) {
+                uint32_t bits = words[w];
+                while (bits != 0) {
+                    visit(w * 32 + lowest_bit(bits));
+                    bits &= bits - 1;
                 };
-                row = row.substr(0, row.length() - 1);
-                result += row + "\n";
             };
-            string bias_str = to_string(bias);
-            result += bias_str + "\n\n";
-            return result;
         };
 
-        // SETTERS
-
         /**
-         * @brief Método utilizado para asignar un nuevo vector de pesos a la neurona.
+         * @brief Método utilizado para obtener un hash de 64 bits de los píxeles (para tablas de caracteres).
         */
-        void set_weights(vector<vector<float>> newWeights) {
-            weights = newWeights;
+        uint64_t hash() const {
+            uint64_t value = 0x9E3779B97F4A7C15ull;
+            for (int w = 0; w < WORDS; w++) {
+                value = (value ^ words[w]) * 0xBF58476D1CE4E5B9ull;
+                value ^= value >> 31;
+            };
+            return value;
         };
 
         /**
-         * @brief Método utilizado para asignar un nuevo sesgo (o bias) a la neurona.
+         * @brief Operador de igualdad: dos caracteres son iguales si todos sus píxeles coinciden.
         */
-        void set_bias(float newBias) {
-            bias = newBias;
+        bool operator==(const BasicGlyph &other) const {
+            for (int w = 0; w < WORDS; w++) {
+                if (words[w] != other.words[w]) {
+                    return false;
+                };
+            };
+            return true;
         };
 };
 
 /**
- * @brief Clase NeuralNetwork que modela una red neuronal de N perceptrones simples.
- * 
- * Se utiliza para analizar el problema planteado en el enunciado: identificar o reconocer
- * letras vocales minúsculas (a, e, i, o, u), a través de una matriz de entrada. La salida 
- * de la red neuronal es un vector de enteros de tamaño N.    
+ * @brief Caracter de 16x10 utilizado para las vocales.
+*/
+using Glyph = BasicGlyph<ROWS_NUM, COLUMNS_NUM>;
+
+/**
+ * @brief Patrón de entrenamiento: un caracter y el vector canónico de la clase que representa.
+*/
+template <int Rows, int Columns>
+using BasicPattern = pair<BasicGlyph<Rows, Columns>, vector<int>>;
+
+using Pattern = BasicPattern<ROWS_NUM, COLUMNS_NUM>;
+
+/**
+ * @brief Clase BasicSparseGlyph que ve un caracter como la lista de posiciones lineales (fila * Columns + columna) 
+ * de sus píxeles encendidos, en orden creciente. Tiene la misma interfaz for_each_active que BasicGlyph, así que la 
+ * suma ponderada y la Regla Delta recorren solo los píxeles encendidos sin buscar bits. No guarda los índices: 
+ * apunta a un tramo de un BasicSparseGlyphSet.
 */
-class NeuralNetwork {
+template <int Rows, int Columns>
+class BasicSparseGlyph {
     public:
-        vector<Perceptron> perceptrons;
-        int iterationsNumber;
+        const uint16_t *first;
+        const uint16_t *last;
 
         /**
-         * @brief Constructor de la clase NeuralNetwork.
-         * 
-         * @param aIterationsNumber Parámetro de tipo entero que determina el número de iteraciones que hará la red neuronal
-         * para entrenar y aprender los patrones.
-         * @param aPerceptronsNumber Parámetro de tipo entero necesario para determinar el número de perceptrones (neuronas) 
-         * en la red neuronal. 
+         * @brief Constructor de la clase BasicSparseGlyph.
+         *  
+         * @param aFirst Parámetro de tipo puntero al primer índice del caracter.
+         * @param aLast Parámetro de tipo puntero al final (exclusivo) de sus índices.
         */
-        NeuralNetwork(int aPerceptronsNumber, int aIterationsNumber) {
-            for (int i = 0; i < aPerceptronsNumber; i++) {
-                Perceptron newPerceptron(LEARNING_RATE, 42);
-                perceptrons.push_back(newPerceptron);
-            };
-            iterationsNumber = aIterationsNumber;
-        }
+        BasicSparseGlyph(const uint16_t *aFirst, const uint16_t *aLast) {
+            first = aFirst;
+            last = aLast;
+        };
 
         /**
-         * @brief Método utilizado para procesar un patrón específico con la red neuronal.
-         * 
-         * @param inputValues Parámetro de tipo vector de vectores de enteros que representa la entrada de la red neuronal.
-         * 
-         * @return Vector de números de coma flotante (salidas de la función de activación de cada neurona de la red neuronal).
+         * @brief Método utilizado para visitar los píxeles encendidos, en orden creciente.
         */
-        vector<float> process_input(vector<vector<int>> inputValues) {
-            vector<float> output = {};
-            for (int i = 0; i < perceptrons.size(); i++) {
-                float predict = perceptrons[i].activation_function(inputValues);
-                output.push_back(predict);
+        template <typename Visitor>
+        void for_each_active(Visitor visit) const {
+            for (const uint16_t *index = first; index != last; index++) {
+                visit(*index);
             };
-            return output;
         };
 
         /**
-         * @brief Método utilizado para entrenar a la red neuronal con un conjunto de patrones. Durante un número de iteraciones
-         * determinado, se eligirá aleatoriamente el patrón con el que se desea entrenar y la red neuronal empezará a procesarlo con 
-         * todas los perceptrones (neuronas); reajustando sus pesos cuando sea necesario.
-         * 
-         * @param patterns Parámetro de tipo vector de pares de matrices y vectores utilizado para representar una entrada
-         * y su salida esperada.
+         * @brief Método utilizado para volver al caracter empaquetado.
         */
-        void training(vector<pair<vector<vector<int>>, vector<int>>> patterns) {
-            int n = patterns.size();
-            for (int iteration = 0; iteration < iterationsNumber; iteration++) {
-                int index = rand() % n;
-                vector<vector<int>> input = patterns[index].first;
-                vector<int> expectedValue = patterns[index].second;
-                vector<float> output = process_input(input);
-                
-                for (int i = 0; i < output.size(); i++) {
-                    int outputValue = round(output[i]);
-                    int error = expectedValue[i] - outputValue;
-                    if (error != 0) {
-                        perceptrons[i].adjust_weights(input, expectedValue[i], outputValue);
-                        perceptrons[i].adjust_bias(expectedValue[i], outputValue);
-                    };
-                };
+        BasicGlyph<Rows, Columns> to_glyph() const {
+            BasicGlyph<Rows, Columns> glyph;
+            for (const uint16_t *index = first; index != last; index++) {
+                glyph.set(*index / Columns, *index % Columns, true);
             };
+            return glyph;
+        };
+};
+
+/**
+ * @brief Clase BasicSparseGlyphSet que guarda los índices de muchos caracteres seguidos en un único vector: cada 
+ * caracter ocupa 2 bytes por píxel encendido más su desplazamiento, en lugar de un arreglo fijo de Rows * Columns 
+ * índices.
+*/
+template <int Rows, int Columns>
+class BasicSparseGlyphSet {
+    public:
+        using SparseGlyphType = BasicSparseGlyph<Rows, Columns>;
+
+        vector<uint16_t> indices;
+        // El caracter i ocupa indices[offsets[i]] ... indices[offsets[i + 1] - 1]
+        vector<uint32_t> offsets;
+
+        BasicSparseGlyphSet() {
+            offsets.push_back(0);
         };
 
         /**
-         * @brief Método utilizado para identificar o reconocer la matriz de entrada a través de la red neuronal 
-         * previamente entrenada. Este devuelve un vector de tamaño N.
-         * 
-         * @param inputValues Parámetro de tipo vector de vectores de enteros que representa la entrada 
-         * de la red neuronal.
-         * 
-         * @return Vector de números enteros (respuesta de la red neuronal ante un patrón de entrada).
+         * @brief Método utilizado para añadir un caracter empaquetado al final del conjunto.
         */
-        vector<int> resolve(vector<vector<int>> inputValues) {
-            vector<float> output = {};
-            for (int i = 0; i < perceptrons.size(); i++) {
-                float result = perceptrons[i].activation_function(inputValues);
-                output.push_back(result);
-            };
+        void add(const BasicGlyph<Rows, Columns> &glyph) {
+            glyph.for_each_active([this](int index) {
+                indices.push_back(static_cast<uint16_t>(index));
+            });
+            offsets.push_back(static_cast<uint32_t>(indices.size()));
+        };
+
+        size_t size() const {
+            return offsets.size() - 1;
+        };
+
+        SparseGlyphType operator[](size_t i) const {
+            return SparseGlyphType(indices.data() + offsets[i], indices.data() + offsets[i + 1]);
+        };
+};
+
+using SparseGlyph = BasicSparseGlyph<ROWS_NUM, COLUMNS_NUM>;
+
+/**
+ * @brief Parámetros del entrenamiento: número máximo de épocas, tamaño del mini-lote (0 = lote completo), semilla 
+ * con la que cada neurona baraja los patrones y paciencia (épocas sin mejorar antes de detenerse; 0 = sin parada 
+ * temprana salvo por convergencia).
+*/
+struct TrainingConfig {
+    int epochs;
+    int batchSize;
+    unsigned int seed;
+    int patience = 0;
+};
+
+/**
+ * @brief Estadísticas de una época de entrenamiento de una neurona: patrones mal clasificados, pérdida (error 
+ * cuadrático medio) y errores de validación (-1 si no hay conjunto de validación).
+*/
+struct EpochStats {
+    int errors;
+    float loss;
+    int validationErrors;
+};
+
+/**
+ * @brief Resultado del entrenamiento de una neurona: estadísticas de cada época recorrida, época cuyos pesos se 
+ * conservaron (1 = la primera) y si terminó por convergencia (una época sin errores).
+*/
+struct TrainingReport {
+    vector<EpochStats> epochs;
+    int bestEpoch;
+    bool converged;
+};
+
+/**
+ * @brief Función que baraja un vector de índices (Fisher-Yates) con el generador dado. Se implementa aquí para que 
+ * el orden sea el mismo con cualquier biblioteca estándar.
+*/
+template <typename Index>
+void shuffle_indices(vector<Index> &indices, mt19937 &shuffler) {
+    for (size_t i = indices.size(); i > 1; i--) {
+        size_t j = shuffler() % i;
+        std::swap(indices[i - 1], indices[j]);
+    };
+};
+
+/**
+ * @brief Parámetros de la aumentación de datos: desplazamiento máximo (en píxeles), rotación máxima (en grados), 
+ * probabilidades de dilatar o erosionar el trazo y número de píxeles invertidos como ruido.
+*/
+struct AugmentationConfig {
+    int maxShift;
+    float maxRotation;
+    float dilationProbability;
+    float erosionProbability;
+    int noiseFlips;
+};
+
+/**
+ * @brief Muestra generada por la aumentación: el caracter transformado y el índice de su clase (-1 si ninguna).
+*/
+template <typename GlyphType>
+struct AugmentedSample {
+    GlyphType glyph;
+    int label;
+};
+
+/**
+ * @brief Función que desplaza un caracter rows filas y columns columnas (los píxeles que salen se pierden).
+*/
+template <typename GlyphType>
+GlyphType shift_glyph(const GlyphType &glyph, int rows, int columns) {
+    GlyphType result;
+    glyph.for_each_active([&](int index) {
+        int row = index / GlyphType::COLUMNS + rows;
+        int column = index % GlyphType::COLUMNS + columns;
+        if (row >= 0 && row < GlyphType::ROWS && column >= 0 && column < GlyphType::COLUMNS) {
+            result.set(row, column, true);
+        };
+    });
+    return result;
+};
+
+/**
+ * @brief Función que rota un caracter alrededor de su centro (vecino más cercano).
+ * 
+ * @param degrees Parámetro de tipo número de coma flotante con el ángulo en grados.
+*/
+template <typename GlyphType>
+GlyphType rotate_glyph(const GlyphType &glyph, float degrees) {
+    GlyphType result;
+    float radians = degrees * 3.14159265f / 180;
+    float cosine = std::cos(radians);
+    float sine = std::sin(radians);
+    float centerRow = (GlyphType::ROWS - 1) / 2.0f;
+    float centerColumn = (GlyphType::COLUMNS - 1) / 2.0f;
+    for (int i = 0; i < GlyphType::ROWS; i++) {
+        for (int j = 0; j < GlyphType::COLUMNS; j++) {
+            int row = static_cast<int>(std::lround(centerRow + (i - centerRow) * cosine + (j - centerColumn) * sine));
+            int column = static_cast<int>(std::lround(centerColumn - (i - centerRow) * sine + (j - centerColumn) * cosine));
+            if (row >= 0 && row < GlyphType::ROWS && column >= 0 && column < GlyphType::COLUMNS && glyph.get(row, column)) {
+                result.set(i, j, true);
+            };
+        };
+    };
+    return result;
+};
+
+/**
+ * @brief Función que dilata (engrosa) o erosiona (adelgaza) el trazo de un caracter con sus 4 vecinos. Al dilatar 
+ * se enciende todo píxel con algún vecino encendido; al erosionar se apaga todo píxel con algún vecino apagado.
+*/
+template <typename GlyphType>
+GlyphType morph_glyph(const GlyphType &glyph, bool dilate) {
+    GlyphType result;
+    const int offsets[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+    for (int i = 0; i < GlyphType::ROWS; i++) {
+        for (int j = 0; j < GlyphType::COLUMNS; j++) {
+            bool value = glyph.get(i, j);
+            for (const int *offset : offsets) {
+                int row = i + offset[0];
+                int column = j + offset[1];
+                bool neighbour = row >= 0 && row < GlyphType::ROWS && column >= 0 && column < GlyphType::COLUMNS &&
+                                 glyph.get(row, column);
+                value = dilate ? (value || neighbour) : (value && neighbour);
+            };
+            result.set(i, j, value);
+        };
+    };
+    return result;
+};
+
+/**
+ * @brief Función que genera una variante aleatoria de un caracter: rotación, desplazamiento, dilatación o erosión 
+ * y ruido, en ese orden. Una erosión que borre más de la mitad del trazo se descarta.
+ * 
+ * @param glyph Parámetro de tipo caracter original.
+ * @param config Parámetro de tipo AugmentationConfig.
+ * @param random Parámetro de tipo generador de números aleatorios.
+ * 
+ * @return Caracter transformado.
+*/
+template <typename GlyphType, typename Random>
+GlyphType augment_glyph(const GlyphType &glyph, const AugmentationConfig &config, Random &random) {
+    std::uniform_real_distribution<float> unit(0, 1);
+    GlyphType result = glyph;
+    if (config.maxRotation > 0) {
+        result = rotate_glyph(result, (2 * unit(random) - 1) * config.maxRotation);
+    };
+    if (config.maxShift > 0) {
+        std::uniform_int_distribution<int> shift(-config.maxShift, config.maxShift);
+        int rows = shift(random);
+        int columns = shift(random);
+        result = shift_glyph(result, rows, columns);
+    };
+    float morphology = unit(random);
+    if (morphology < config.dilationProbability) {
+        result = morph_glyph(result, true);
+    } else if (morphology < config.dilationProbability + config.erosionProbability) {
+        GlyphType eroded = morph_glyph(result, false);
+        if (2 * eroded.count() >= result.count()) {
+            result = eroded;
+        };
+    };
+    for (int f = 0; f < config.noiseFlips; f++) {
+        int index = random() % GlyphType::PIXELS;
+        result.set(index / GlyphType::COLUMNS, index % GlyphType::COLUMNS, !result.test(index));
+    };
+    return result;
+};
+
+/**
+ * @brief Clase MappedFile que expone el contenido completo de un archivo como un bloque de memoria de solo lectura.
+ * 
+ * En sistemas POSIX el archivo se proyecta en memoria (mmap); en el resto se lee de una vez en un búfer.
+*/
+class MappedFile {
+    public:
+        const char *data;
+        size_t size;
+        bool mapped;
+        vector<char> buffer;
+
+        /**
+         * @brief Constructor de la clase MappedFile. No abre ningún archivo.
+        */
+        MappedFile() {
+            data = nullptr;
+            size = 0;
+            mapped = false;
+        };
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        /**
+         * @brief Destructor de la clase MappedFile. Libera la proyección o el búfer.
+        */
+        ~MappedFile() {
+            release();
+        };
+
+        /**
+         * @brief Método utilizado para abrir un archivo y dejar su contenido disponible en data/size.
+         * 
+         * @param filename Parámetro de tipo cadena de caracteres que representa el nombre del archivo.
+         * 
+         * @return Valor booleano (verdadero si se pudo abrir el archivo).
+        */
+        bool open(const string &filename) {
+            release();
+#if defined(PERCEPTRON_HAS_MMAP)
+            int descriptor = ::open(filename.c_str(), O_RDONLY);
+            if (descriptor < 0) {
+                return false;
+            };
+            struct stat info;
+            if (fstat(descriptor, &info) == 0 && info.st_size > 0) {
+                void *address = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+                if (address != MAP_FAILED) {
+                    data = static_cast<const char *>(address);
+                    size = info.st_size;
+                    mapped = true;
+                };
+            };
+            ::close(descriptor);
+            if (mapped) {
+                return true;
+            };
+#endif
+            std::ifstream input(filename, std::ios::in | std::ios::binary);
+            if (!input) {
+                return false;
+            };
+            input.seekg(0, std::ios::end);
+            std::streamoff length = input.tellg();
+            if (length >= 0) {
+                buffer.resize(static_cast<size_t>(length));
+                input.seekg(0, std::ios::beg);
+                input.read(buffer.data(), buffer.size());
+            } else {
+                // Una tubería no admite seekg: se lee hasta que el escritor la cierra
+                input.clear();
+                buffer.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+            };
+            data = buffer.data();
+            size = buffer.size();
+            return true;
+        };
+
+        /**
+         * @brief Método utilizado para liberar la proyección o el búfer del archivo.
+        */
+        void release() {
+#if defined(PERCEPTRON_HAS_MMAP)
+            if (mapped) {
+                munmap(const_cast<char *>(data), size);
+            };
+#endif
+            buffer.clear();
+            data = nullptr;
+            size = 0;
+            mapped = false;
+        };
+};
+
+/**
+ * @brief Clase TextScanner que decodifica directamente, sin flujos ni conversiones dependientes del locale, las 
+ * matrices de ceros y unos y los números de coma flotante de un bloque de texto en memoria.
+*/
+class TextScanner {
+    public:
+        const char *cursor;
+        const char *end;
+
+        /**
+         * @brief Constructor de la clase TextScanner.
+         * 
+         * @param aBegin Puntero al primer caracter del texto.
+         * @param aEnd Puntero a la posición siguiente al último caracter del texto.
+        */
+        TextScanner(const char *aBegin = nullptr, const char *aEnd = nullptr) {
+            cursor = aBegin;
+            end = aEnd;
+        };
+
+        /**
+         * @brief Método utilizado para saber si ya se recorrió todo el texto.
+        */
+        bool at_end() const {
+            return cursor >= end;
+        };
+
+        /**
+         * @brief Método utilizado para saltar espacios, tabulaciones y retornos de carro dentro de la línea actual.
+        */
+        void skip_spaces() {
+            while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) {
+                cursor++;
+            };
+        };
+
+        /**
+         * @brief Método utilizado para saltar las líneas en blanco (los separadores entre matrices).
+         * 
+         * @return Valor booleano (verdadero si queda una línea con contenido; el cursor queda al inicio de ella).
+        */
+        bool skip_blank_lines() {
+            while (cursor < end) {
+                const char *lineStart = cursor;
+                skip_spaces();
+                if (cursor < end && *cursor == '\n') {
+                    cursor++;
+                    continue;
+                };
+                if (cursor < end) {
+                    cursor = lineStart;
+                    return true;
+                };
+            };
+            return false;
+        };
+
+        /**
+         * @brief Método utilizado para saltar al inicio de la siguiente línea.
+        */
+        void line_break() {
+            while (cursor < end && *cursor != '\n') {
+                cursor++;
+            };
+            if (cursor < end) {
+                cursor++;
+            };
+        };
+
+        /**
+         * @brief Método utilizado para decodificar una fila de la matriz (hasta GlyphType::COLUMNS valores) y avanzar 
+         * a la siguiente línea. Un valor distinto de cero enciende el píxel.
+         * 
+         * @param glyph Parámetro de tipo GlyphType (BasicGlyph) donde se escribe la fila.
+         * @param row Parámetro de tipo entero con el número de fila.
+        */
+        template <typename GlyphType>
+        void parse_glyph_row(GlyphType &glyph, int row) {
+            int column = 0;
+            while (true) {
+                skip_spaces();
+                if (cursor >= end || *cursor == '\n') {
+                    break;
+                };
+                bool active = false;
+                while (cursor < end && *cursor != ' ' && *cursor != '\t' && *cursor != '\r' && *cursor != '\n') {
+                    active = active || (*cursor >= '1' && *cursor <= '9');
+                    cursor++;
+                };
+                if (column < GlyphType::COLUMNS) {
+                    glyph.set(row, column, active);
+                };
+                column++;
+            };
+            line_break();
+        };
+
+        /**
+         * @brief Método utilizado para decodificar una matriz de GlyphType::ROWS filas a partir de la línea actual.
+         * 
+         * @return Caracter empaquetado (GlyphType) con los píxeles encendidos de la matriz.
+        */
+        template <typename GlyphType = Glyph>
+        GlyphType parse_glyph() {
+            GlyphType glyph;
+            for (int i = 0; i < GlyphType::ROWS; i++) {
+                parse_glyph_row(glyph, i);
+            };
+            return glyph;
+        };
+
+        /**
+         * @brief Método utilizado para decodificar la siguiente matriz, saltando antes las líneas en blanco que la 
+         * separan de la anterior.
+         * 
+         * @param glyph Parámetro de tipo GlyphType (BasicGlyph) donde se escribe la matriz.
+         * 
+         * @return Valor booleano (falso si se llegó al final del texto o la siguiente línea no es una fila de ceros y unos).
+        */
+        template <typename GlyphType>
+        bool next_glyph(GlyphType &glyph) {
+            if (!skip_blank_lines()) {
+                return false;
+            };
+            const char *lineStart = cursor;
+            skip_spaces();
+            bool isRow = cursor < end && *cursor >= '0' && *cursor <= '9';
+            cursor = lineStart;
+            if (!isRow) {
+                return false;
+            };
+            glyph = parse_glyph<GlyphType>();
+            return true;
+        };
+
+        /**
+         * @brief Método utilizado para decodificar un número de coma flotante (signo, parte entera, parte decimal y 
+         * exponente opcional) a partir de la posición actual.
+         * 
+         * @return Número de coma flotante. Lanza std::invalid_argument si no hay ningún dígito, igual que stof.
+        */
+        float parse_float() {
+            static const double POWERS[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+            skip_spaces();
+            bool negative = false;
+            if (cursor < end && (*cursor == '-' || *cursor == '+')) {
+                negative = *cursor == '-';
+                cursor++;
+            };
+
+            uint64_t mantissa = 0;
+            int exponent = 0;
+            int significant = 0;
+            bool anyDigit = false;
+            while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+                if (significant < 19) {
+                    mantissa = mantissa * 10 + (*cursor - '0');
+                    significant += mantissa != 0;
+                } else {
+                    exponent++;
+                };
+                anyDigit = true;
+                cursor++;
+            };
+            if (cursor < end && *cursor == '.') {
+                cursor++;
+                while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+                    if (significant < 19) {
+                        mantissa = mantissa * 10 + (*cursor - '0');
+                        significant += mantissa != 0;
+                        exponent--;
+                    };
+                    anyDigit = true;
+                    cursor++;
+                };
+            };
+            if (!anyDigit) {
+                throw std::invalid_argument("parse_float");
+            };
+            if (cursor < end && (*cursor == 'e' || *cursor == 'E')) {
+                cursor++;
+                bool negativeExponent = false;
+                if (cursor < end && (*cursor == '-' || *cursor == '+')) {
+                    negativeExponent = *cursor == '-';
+                    cursor++;
+                };
+                int value = 0;
+                while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+                    value = std::min(value * 10 + (*cursor - '0'), 10000);
+                    cursor++;
+                };
+                exponent += negativeExponent ? -value : value;
+            };
+
+            // Con mantisa de hasta 53 bits y potencia exacta el resultado en double queda bien redondeado.
+            double result = static_cast<double>(mantissa);
+            if (exponent < 0 && exponent >= -22) {
+                result /= POWERS[-exponent];
+            } else if (exponent > 0 && exponent <= 22) {
+                result *= POWERS[exponent];
+            } else if (exponent != 0) {
+                result *= std::pow(10.0, exponent);
+            };
+            return static_cast<float>(negative ? -result : result);
+        };
+
+        /**
+         * @brief Método utilizado para decodificar todos los números de coma flotante de la línea actual y avanzar 
+         * a la siguiente.
+         * 
+         * @return Vector de números de coma flotante (una fila de la matriz).
+        */
+        vector<float> parse_float_row() {
+            vector<float> row;
+            while (true) {
+                skip_spaces();
+                if (cursor >= end || *cursor == '\n') {
+                    break;
+                };
+                row.push_back(parse_float());
+            };
+            line_break();
+            return row;
+        };
+};
+
+/**
+ * @brief Clase FileManager que se encarga de manejar la apertura, lectura y escritura de archivos .txt.  
+ * 
+ * En modo lectura el archivo completo queda en memoria (MappedFile) y se decodifica con un TextScanner; en modo 
+ * escritura se utiliza un fstream.
+*/
+class FileManager {
+    public:
+        fstream file;
+        MappedFile content;
+        TextScanner scanner;
+        string mode;
+        string filename;
+
+        /**
+         * @brief Constructor de la clase FileManager.
+         * 
+         * @param aFilename Parámetro de tipo cadena de caracteres que representa el nombre del archivo. 
+         * @param aMode Parámetro de tipo cadena de caracteres que representa el modo de apertura del 
+         * archivo (lectura o escritura).
+        */
+        FileManager(string aFilename, string aMode) {
+            filename = aFilename;
+            mode = aMode;
+            get_file();
+        };
+
+        /**
+         * @brief Método utilizado para parsear una matriz de números de coma flotante dentro de un archivo 
+         * .txt.
+         * 
+         * @param rowsNumber Parámetro de tipo entero con el número de filas de la matriz.
+         * 
+         * @return Vector de vectores de números de coma flotante (matriz de números reales).
+        */
+        vector<vector<float>> parse_float_matrix(int rowsNumber = ROWS_NUM) {
+            vector<vector<float>> matrix;
+            for(int i = 0; i < rowsNumber; i++) {
+                matrix.push_back(scanner.parse_float_row());
+            }
+            return matrix;
+        };
+
+        /**
+         * @brief Método utilizado para parsear una matriz de ceros y unos (un caracter) dentro de un archivo .txt.
+         * 
+         * @return Caracter empaquetado (GlyphType) con los píxeles encendidos de la matriz.
+        */
+        template <typename GlyphType = Glyph>
+        GlyphType parse_glyph() {
+            return scanner.parse_glyph<GlyphType>();
+        };
+
+        /**
+         * @brief Método utilizado para parsear la siguiente matriz de ceros y unos, saltando los separadores.
+         * 
+         * @param glyph Parámetro de tipo GlyphType (BasicGlyph) donde se escribe la matriz.
+         * 
+         * @return Valor booleano (falso si ya no quedan matrices en el archivo).
+        */
+        template <typename GlyphType>
+        bool next_glyph(GlyphType &glyph) {
+            return scanner.next_glyph(glyph);
+        };
+
+        /**
+         * @brief Método utilizado para parsear un número de coma flotante dentro de un archivo .txt.
+         * 
+         * @return Número de coma flotante (número real).
+        */
+        float parse_float() {
+            float number = scanner.parse_float();
+            scanner.line_break();
+
+            return number;
+        }
+
+        // Extras
+
+        /**
+         * @brief Método utilizado para obtener el archivo .txt en el modo especificado por la clase. En modo lectura 
+         * lanza std::runtime_error si el archivo no se puede abrir.
+        */
+        void get_file() {
+            if (mode == "write") {
+                file.open(filename, std::ios::out);
+            } else {
+                if (!content.open(filename)) {
+                    throw std::runtime_error("No se pudo abrir el archivo " + filename + ".");
+                };
+                scanner = TextScanner(content.data, content.data + content.size);
+            }
+            
+        };
+
+        /**
+         * @brief Método utilizado para saber si ya se leyó todo el archivo.
+        */
+        bool eof() const {
+            return scanner.at_end();
+        };
+
+        /**
+         * @brief Método utilizado para escribir en el archivo .txt dado por la clase.
+        */
+        void write(string words) {
+            file << words;
+        };
+
+        /**
+         * @brief Método utilizado para saltar de línea en el archivo .txt dado por la clase.
+        */
+        void line_break() {
+            scanner.line_break();
+        }
+};
+
+/**
+ * @brief Bloque de SIMD_LANES números de coma flotante alineado a 32 bytes (un registro AVX o dos SSE).
+*/
+struct alignas(32) Lane {
+    float values[SIMD_LANES];
+};
+
+/**
+ * @brief Cabecera del formato binario de la base de conocimiento (archivos .bin).
+ * 
+ * Versión 1 (una capa): tras los 32 bytes de cabecera vienen, en float32 y con el orden de bytes del equipo 
+ * (little endian en x86/ARM), los pesos con la disposición de FusedNetwork (PIXELS_NUM filas de lanes bloques Lane, 
+ * una columna por neurona) y después lanes bloques con los sesgos. Como la cabecera ocupa 32 bytes, los datos 
+ * quedan alineados y se pueden usar directamente desde el archivo proyectado en memoria.
+ * 
+ * Versión 2 (red multicapa): hidden indica el número de neuronas ocultas y los datos son el buffer de parámetros 
+ * de LayeredNetwork, en float32 y en su mismo orden.
+*/
+struct KnowledgeBaseHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t rows;
+    uint32_t columns;
+    uint32_t classes;
+    uint32_t lanes;
+    uint32_t checksum;
+    uint32_t hidden;
+};
+
+const char KNOWLEDGE_BASE_MAGIC[4] = {'P', 'S', 'K', 'B'};
+const uint32_t KNOWLEDGE_BASE_VERSION = 1;
+const uint32_t KNOWLEDGE_BASE_LAYERED_VERSION = 2;
+
+/**
+ * @brief Función que calcula la suma de verificación FNV-1a de 32 bits de un bloque de memoria. El último parámetro 
+ * permite continuar la suma de un bloque anterior.
+*/
+uint32_t fnv1a_checksum(const void *data, size_t size, uint32_t hash = 2166136261u) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    };
+    return hash;
+};
+
+/**
+ * @brief Función que indica si un bloque de memoria empieza con la firma del formato binario.
+*/
+bool is_binary_knowledge_base(const char *data, size_t size) {
+    return size >= sizeof(KnowledgeBaseHeader) && std::equal(KNOWLEDGE_BASE_MAGIC, KNOWLEDGE_BASE_MAGIC + 4, data);
+};
+
+/**
+ * @brief Función que valida una base de conocimiento binaria ya cargada en memoria: firma, versión, dimensiones, 
+ * tamaño y suma de verificación.
+ * 
+ * @param content Parámetro de tipo MappedFile con el contenido del archivo.
+ * @param rowsNumber Parámetro de tipo entero con el número de filas esperado.
+ * @param columnsNumber Parámetro de tipo entero con el número de columnas esperado.
+ * @param classesNumber Parámetro de tipo entero con el número de neuronas esperado.
+ * 
+ * @return Puntero a la cabecera validada. Lanza std::runtime_error si el archivo no es válido.
+*/
+const KnowledgeBaseHeader *check_binary_knowledge_base(const MappedFile &content, int rowsNumber, int columnsNumber,
+                                                       int classesNumber) {
+    if (!is_binary_knowledge_base(content.data, content.size)) {
+        throw std::runtime_error("La base de conocimiento no tiene formato binario.");
+    };
+    const KnowledgeBaseHeader *header = reinterpret_cast<const KnowledgeBaseHeader *>(content.data);
+    if (header->version == KNOWLEDGE_BASE_LAYERED_VERSION) {
+        throw std::runtime_error("La base de conocimiento es de una red multicapa (se carga con LayeredNetwork).");
+    };
+    if (header->version != KNOWLEDGE_BASE_VERSION) {
+        throw std::runtime_error("Versión de la base de conocimiento no soportada.");
+    };
+    if (header->rows != static_cast<uint32_t>(rowsNumber) || header->columns != static_cast<uint32_t>(columnsNumber) ||
+        header->classes != static_cast<uint32_t>(classesNumber) ||
+        header->lanes != (header->classes + SIMD_LANES - 1) / SIMD_LANES) {
+        throw std::runtime_error("Las dimensiones de la base de conocimiento no coinciden con la red.");
+    };
+    size_t payload = (static_cast<size_t>(rowsNumber) * columnsNumber + 1) * header->lanes * sizeof(Lane);
+    if (content.size != sizeof(KnowledgeBaseHeader) + payload) {
+        throw std::runtime_error("La base de conocimiento está truncada.");
+    };
+    if (fnv1a_checksum(content.data + sizeof(KnowledgeBaseHeader), payload) != header->checksum) {
+        throw std::runtime_error("La suma de verificación de la base de conocimiento no coincide.");
+    };
+    return header;
+};
+
+/**
+ * @brief Función que valida una base de conocimiento binaria de la versión 2 (red multicapa) ya cargada en memoria.
+ * 
+ * @return Puntero a la cabecera validada. Lanza std::runtime_error si el archivo no es válido.
+*/
+const KnowledgeBaseHeader *check_layered_knowledge_base(const MappedFile &content, int rowsNumber, int columnsNumber,
+                                                        int classesNumber) {
+    if (!is_binary_knowledge_base(content.data, content.size)) {
+        throw std::runtime_error("La base de conocimiento no tiene formato binario.");
+    };
+    const KnowledgeBaseHeader *header = reinterpret_cast<const KnowledgeBaseHeader *>(content.data);
+    if (header->version != KNOWLEDGE_BASE_LAYERED_VERSION) {
+        throw std::runtime_error("Versión de la base de conocimiento no soportada.");
+    };
+    if (header->rows != static_cast<uint32_t>(rowsNumber) || header->columns != static_cast<uint32_t>(columnsNumber) ||
+        header->classes != static_cast<uint32_t>(classesNumber) || header->hidden == 0) {
+        throw std::runtime_error("Las dimensiones de la base de conocimiento no coinciden con la red.");
+    };
+    size_t pixels = static_cast<size_t>(rowsNumber) * columnsNumber;
+    size_t payload = ((pixels + 1) * header->hidden + (header->hidden + 1) * static_cast<size_t>(classesNumber)) * sizeof(float);
+    if (content.size != sizeof(KnowledgeBaseHeader) + payload) {
+        throw std::runtime_error("La base de conocimiento está truncada.");
+    };
+    if (fnv1a_checksum(content.data + sizeof(KnowledgeBaseHeader), payload) != header->checksum) {
+        throw std::runtime_error("La suma de verificación de la base de conocimiento no coincide.");
+    };
+    return header;
+};
+
+/**
+ * @brief Función que escribe una base de conocimiento binaria.
+ * 
+ * @param filename Parámetro de tipo cadena de caracteres con el nombre del archivo.
+ * @param rowsNumber Parámetro de tipo entero con el número de filas del caracter.
+ * @param columnsNumber Parámetro de tipo entero con el número de columnas del caracter.
+ * @param classesNumber Parámetro de tipo entero con el número de neuronas.
+ * @param weights Parámetro de tipo puntero a los bloques de pesos en la disposición de FusedNetwork.
+ * @param biases Parámetro de tipo puntero a los bloques de sesgos.
+*/
+void write_binary_knowledge_base(const string &filename, int rowsNumber, int columnsNumber, int classesNumber,
+                                 const Lane *weights, const Lane *biases) {
+    KnowledgeBaseHeader header = {};
+    std::copy(KNOWLEDGE_BASE_MAGIC, KNOWLEDGE_BASE_MAGIC + 4, header.magic);
+    header.version = KNOWLEDGE_BASE_VERSION;
+    header.rows = rowsNumber;
+    header.columns = columnsNumber;
+    header.classes = classesNumber;
+    header.lanes = (classesNumber + SIMD_LANES - 1) / SIMD_LANES;
+
+    size_t weightsSize = static_cast<size_t>(rowsNumber) * columnsNumber * header.lanes * sizeof(Lane);
+    size_t biasesSize = header.lanes * sizeof(Lane);
+    header.checksum = fnv1a_checksum(biases, biasesSize, fnv1a_checksum(weights, weightsSize));
+
+    std::ofstream output(filename, std::ios::out | std::ios::binary);
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char *>(weights), weightsSize);
+    output.write(reinterpret_cast<const char *>(biases), biasesSize);
+    if (!output) {
+        throw std::runtime_error("No se pudo escribir la base de conocimiento " + filename + ".");
+    };
+};
+
+/**
+ * @brief Función que escribe una base de conocimiento binaria de la versión 2 (red multicapa).
+ * 
+ * @param filename Parámetro de tipo cadena de caracteres con el nombre del archivo.
+ * @param rowsNumber Parámetro de tipo entero con el número de filas del caracter.
+ * @param columnsNumber Parámetro de tipo entero con el número de columnas del caracter.
+ * @param classesNumber Parámetro de tipo entero con el número de neuronas de salida.
+ * @param hiddenNumber Parámetro de tipo entero con el número de neuronas ocultas.
+ * @param parameters Parámetro de tipo puntero al buffer de parámetros de la red.
+ * @param count Parámetro de tipo entero con el número de parámetros.
+*/
+void write_layered_knowledge_base(const string &filename, int rowsNumber, int columnsNumber, int classesNumber,
+                                  int hiddenNumber, const float *parameters, size_t count) {
+    KnowledgeBaseHeader header = {};
+    std::copy(KNOWLEDGE_BASE_MAGIC, KNOWLEDGE_BASE_MAGIC + 4, header.magic);
+    header.version = KNOWLEDGE_BASE_LAYERED_VERSION;
+    header.rows = rowsNumber;
+    header.columns = columnsNumber;
+    header.classes = classesNumber;
+    header.lanes = (classesNumber + SIMD_LANES - 1) / SIMD_LANES;
+    header.hidden = hiddenNumber;
+    header.checksum = fnv1a_checksum(parameters, count * sizeof(float));
+
+    std::ofstream output(filename, std::ios::out | std::ios::binary);
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char *>(parameters), count * sizeof(float));
+    if (!output) {
+        throw std::runtime_error("No se pudo escribir la base de conocimiento " + filename + ".");
+    };
+};
+
+/**
+ * @brief Clase BasicPerceptron que modela la neurona propuesta por Frank Rosenblatt.
+ * 
+ * Se utiliza como una neuorna individual en una red neuronal. Posee N número de entradas (dendritas), con
+ * sus respectivos pesos, una razón de aprendizaje, la sumatoria ponderada y una función de activación.   
+ * 
+ * Las dimensiones de la entrada (Rows x Columns) son parámetros de plantilla: los pesos se guardan en un 
+ * std::array contiguo y los ciclos tienen límites constantes, así el compilador puede desenrollarlos.
+*/
+template <int Rows, int Columns>
+class BasicPerceptron {
+    public:
+        static constexpr int PIXELS = Rows * Columns;
+        using GlyphType = BasicGlyph<Rows, Columns>;
+        using PatternType = BasicPattern<Rows, Columns>;
+
+        int randomState;
+        float bias;
+        std::array<std::array<float, Columns>, Rows> weights;
+        float learningRate;
+
+        /**
+         * @brief Constructor por defecto de la clase BasicPerceptron: pesos y sesgo en cero.
+        */
+        BasicPerceptron() {
+            learningRate = LEARNING_RATE;
+            randomState = RANDOM_STATE;
+            bias = 0;
+            for (std::array<float, Columns> &row : weights) {
+                row.fill(0);
+            };
+        };
+
+        /**
+         * @brief Constructor de la clase BasicPerceptron.
+         * 
+         * @param aLearningRate Parámetro de tipo flotante necesario para otorgar la razón de aprendizaje de la neurona. 
+         * @param aRandomState Parámetro de tipo entero necesario para otorgar la semilla de aleatoriedad para generar 
+         * los pesos de la neurona.
+        */
+        BasicPerceptron(float aLearningRate, int aRandomState) {
+            learningRate = aLearningRate;
+            randomState = aRandomState;
+            initialize_bias();
+            initialize_weights();
+        };
+
+        /**
+         * @brief Constructor de la clase BasicPerceptron con un generador propio en lugar del global, para crear 
+         * redes en paralelo sin compartir estado aleatorio.
+         * 
+         * @param aLearningRate Parámetro de tipo flotante con la razón de aprendizaje de la neurona.
+         * @param random Parámetro de tipo generador (mt19937) del que se toman el sesgo y los pesos iniciales.
+        */
+        BasicPerceptron(float aLearningRate, mt19937 &random) {
+            learningRate = aLearningRate;
+            randomState = RANDOM_STATE;
+            initialize_bias(random);
+            initialize_weights(random);
+        };
+
+        /**
+         * @brief Método utilizado para calcular la suma ponderada en base a las entradas y los pesos de la neurona. 
+         * Se utiliza un producto punto entre el vector de entradas y el vector de pesos y, al final, se le suma el
+         * sesgo (o bias). Fórmula: sum(x * w) + bias
+         * 
+         * Como las entradas son binarias, el producto punto se reduce a sumar los pesos de los píxeles encendidos.
+         * 
+         * @param inputValues Parámetro de tipo Glyph (matriz binaria empaquetada) o SparseGlyph (lista de píxeles 
+         * encendidos) que hace referencia a los valores de entrada de la neurona.
+         * 
+         * @return Número de coma flotante (resultado de la suma ponderada).
+        */
+        template <typename InputType>
+        float net_input(const InputType &inputValues) const {
+            float result = 0;
+            inputValues.for_each_active([&](int index) {
+                result += weights[index / Columns][index % Columns];
+            });
+            return result + bias;
+        };
+
+        /**
+         * @brief Método utilizado para describir la función de activación de la neurona (función sigmoide). 
+         * Se utiliza para determinar si las entradas son capaces de activar (excitar) o no (inhibir) a la neurona.
+         * 
+         * @param inputValues Parámetro de tipo Glyph (matriz binaria empaquetada) o SparseGlyph (lista de píxeles 
+         * encendidos) que hace referencia a los valores de entrada de la neurona.
+         * 
+         * @return Número de coma flotante (salida de la función sigmoide evaluada en el resultado de la suma ponderada).
+        */
+        template <typename InputType>
+        float activation_function(const InputType &inputValues) const {
+            float weightedSum = net_input(inputValues);
+            return 1 / (1 + exp(-weightedSum));
+        };
+
+        // AJUSTES DE LA NEURONA
+
+        /**
+         * @brief Método utilizado para ajustar los pesos del perceptron (neuorna) a través de la Regla Delta. 
+         * Fórmula: w + L(s - y)x. Los píxeles apagados (x = 0) no modifican su peso, así que solo se recorren 
+         * los encendidos.
+         * 
+         * @param inputValues Parámetro de tipo Glyph (matriz binaria empaquetada) o SparseGlyph (lista de píxeles 
+         * encendidos) que hace referencia a los valores de entrada de la neurona.
+         * @param expectedValue Parámetro de tipo entero que hace referencia al valor esperado en la salida de
+         * la neurona.
+         * @param outputValue Parámetro de tipo número de coma flotante que hace referencia al valor obtenido 
+         * en la salida de la neurona.
+        */
+        template <typename InputType>
+        void adjust_weights(const InputType &inputValues, int expectedValue, int outputValue) {
+            float delta = learningRate * (expectedValue - outputValue);
+            inputValues.for_each_active([&](int index) {
+                weights[index / Columns][index % Columns] += delta;
+            });
+        };
+
+        /**
+         * @brief Método utilizado para ajustar el sesgo (o bias) del perceptron (neuorna) a través de la Regla Delta. 
+         * Fórmula: b + L(s - y)1
+         * 
+         * @param expectedValue Parámetro de tipo entero que hace referencia al valor esperado en la salida de
+         * la neurona.
+         * @param outputValue Parámetro de tipo número de coma flotante que hace referencia al valor obtenido 
+         * en la salida de la neurona.
+        */
+        void adjust_bias(int expectedValue, int outputValue) {
+            bias += learningRate * (expectedValue - outputValue) * 1;
+        };
+
+        /**
+         * @brief Método utilizado para aplicar la Regla Delta acumulada sobre un lote de patrones. 
+         * Fórmula: w + (L / n) sum((s - y)x) y b + (L / n) sum(s - y)
+         * 
+         * @param weightErrors Parámetro de tipo arreglo de números de coma flotante con la suma de (s - y)x de cada 
+         * píxel (posición lineal fila * Columns + columna).
+         * @param biasError Parámetro de tipo número de coma flotante con la suma de (s - y) del lote.
+         * @param batchLength Parámetro de tipo entero con el número de patrones del lote.
+        */
+        void adjust_batch(const std::array<float, PIXELS> &weightErrors, float biasError, int batchLength) {
+            float rate = learningRate / batchLength;
+            for (int i = 0; i < Rows; i++) {
+                for (int j = 0; j < Columns; j++) {
+                    weights[i][j] += rate * weightErrors[i * Columns + j];
+                };
+            };
+            bias += rate * biasError;
+        };
+
+        /**
+         * @brief Método utilizado para aplicar la Regla Delta acumulada solo sobre los píxeles tocados por el lote 
+         * (el resto tiene error 0 y su peso no cambia). Equivale a adjust_batch en O(píxeles tocados).
+         * 
+         * @param weightErrors Parámetro de tipo arreglo de números de coma flotante con la suma de (s - y)x de cada 
+         * píxel.
+         * @param touched Parámetro de tipo vector con las posiciones lineales de los píxeles tocados.
+         * @param biasError Parámetro de tipo número de coma flotante con la suma de (s - y) del lote.
+         * @param batchLength Parámetro de tipo entero con el número de patrones del lote.
+        */
+        void adjust_sparse(const std::array<float, PIXELS> &weightErrors, const vector<uint16_t> &touched, float biasError,
+                           int batchLength) {
+            float rate = learningRate / batchLength;
+            for (uint16_t index : touched) {
+                weights[index / Columns][index % Columns] += rate * weightErrors[index];
+            };
+            bias += rate * biasError;
+        };
+
+        // ENTRENAMIENTO DE LA NEURONA
+
+        /**
+         * @brief Método utilizado para entrenar la neurona, de forma independiente del resto, como clasificador uno 
+         * contra todos. En cada época se barajan los patrones con un generador propio (semilla + classIndex) y se 
+         * recorren en mini-lotes; los ajustes de cada lote se promedian y se aplican juntos. Con lote de 1 es la 
+         * Regla Delta clásica, patrón a patrón.
+         * 
+         * @param patterns Parámetro de tipo vector de patrones (PatternType) de entrenamiento.
+         * @param classIndex Parámetro de tipo entero con la posición de esta neurona en el vector de salida esperado.
+         * @param config Parámetro de tipo TrainingConfig con las épocas, el tamaño de lote, la semilla y la paciencia.
+         * @param validation Parámetro de tipo puntero al conjunto de validación (nullptr = sin validación).
+         * 
+         * @return TrainingReport con el error y la pérdida de cada época y la época elegida.
+        */
+        template <typename ValidationType = vector<PatternType>>
+        TrainingReport training(const vector<PatternType> &patterns, int classIndex, const TrainingConfig &config,
+                                const ValidationType *validation = nullptr) {
+            // Los patrones se recorren como listas de píxeles encendidos, todas en un mismo vector
+            BasicSparseGlyphSet<Rows, Columns> inputs;
+            inputs.offsets.reserve(patterns.size() + 1);
+            for (const PatternType &pattern : patterns) {
+                inputs.add(pattern.first);
+            };
+            return train_epochs(patterns.size(), [&inputs](size_t i) {
+                return inputs[i];
+            }, [&patterns, classIndex](size_t i) {
+                return patterns[i].second[classIndex];
+            }, [this, validation, classIndex]() {
+                return validation != nullptr ? validation_errors(*validation, classIndex) : -1;
+            }, classIndex, config);
+        };
+
+        /**
+         * @brief Método utilizado para entrenar la neurona con un conjunto de datos contiguo (BasicPatternDataset o 
+         * una de sus vistas), con el mismo procedimiento que la versión con vector de patrones.
+         * 
+         * @param dataset Parámetro de tipo conjunto de datos con size(), glyph(i) y label(i).
+         * @param classIndex Parámetro de tipo entero con la clase que reconoce esta neurona.
+         * @param config Parámetro de tipo TrainingConfig con las épocas, el tamaño de lote, la semilla y la paciencia.
+         * @param validation Parámetro de tipo puntero al conjunto de validación (nullptr = sin validación).
+         * 
+         * @return TrainingReport con el error y la pérdida de cada época y la época elegida.
+        */
+        template <typename DatasetType, typename ValidationType = DatasetType>
+        TrainingReport training(const DatasetType &dataset, int classIndex, const TrainingConfig &config,
+                                const ValidationType *validation = nullptr) {
+            return train_epochs(dataset.size(), [&dataset](size_t i) -> const GlyphType & {
+                return dataset.glyph(i);
+            }, [&dataset, classIndex](size_t i) {
+                return static_cast<int>(dataset.label(i) == classIndex);
+            }, [this, validation, classIndex]() {
+                return validation != nullptr ? validation_errors(*validation, classIndex) : -1;
+            }, classIndex, config);
+        };
+
+        /**
+         * @brief Método utilizado para contar los patrones de validación que la neurona clasifica mal (salida 
+         * redondeada distinta de la esperada).
+        */
+        int validation_errors(const vector<PatternType> &patterns, int classIndex) const {
+            int errors = 0;
+            for (const PatternType &pattern : patterns) {
+                errors += static_cast<int>(round(activation_function(pattern.first))) != pattern.second[classIndex];
+            };
+            return errors;
+        };
+
+        template <typename DatasetType>
+        int validation_errors(const DatasetType &dataset, int classIndex) const {
+            int errors = 0;
+            for (size_t i = 0; i < dataset.size(); i++) {
+                errors += static_cast<int>(round(activation_function(dataset.glyph(i)))) != (dataset.label(i) == classIndex);
+            };
+            return errors;
+        };
+
+        /**
+         * @brief Método utilizado para recorrer las épocas y mini-lotes del entrenamiento. Solo se ajustan los 
+         * píxeles tocados por cada lote.
+         * 
+         * El error (patrones mal clasificados) y la pérdida (error cuadrático medio de la sigmoide) de cada época se 
+         * acumulan durante el mismo recorrido, con las salidas que ya se calculan para la Regla Delta. Si una época 
+         * termina sin errores, ningún peso cambió en ella y tampoco cambiaría en las siguientes, así que el 
+         * entrenamiento se detiene ahí con el mismo resultado. Con paciencia, se guarda en memoria la mejor época 
+         * (menos errores de validación o, sin validación, de entrenamiento), se detiene tras config.patience épocas 
+         * sin mejorar y se restauran sus pesos.
+         * 
+         * @param count Número de patrones.
+         * @param input Función que devuelve la entrada (GlyphType o SparseGlyph) del patrón i.
+         * @param expected Función que devuelve la salida esperada (0 o 1) del patrón i para esta neurona.
+         * @param validate Función que devuelve los errores de validación con los pesos actuales (-1 = sin validación).
+         * @param classIndex Parámetro de tipo entero con la clase que reconoce esta neurona (cambia la semilla).
+         * @param config Parámetro de tipo TrainingConfig con las épocas, el tamaño de lote, la semilla y la paciencia.
+         * 
+         * @return TrainingReport con el error y la pérdida de cada época y la época elegida.
+        */
+        template <typename InputAt, typename ExpectedAt, typename Validate>
+        TrainingReport train_epochs(size_t count, InputAt input, ExpectedAt expected, Validate validate, int classIndex,
+                                    const TrainingConfig &config) {
+            mt19937 shuffler(config.seed + classIndex);
+            vector<int> order(count);
+            std::iota(order.begin(), order.end(), 0);
+            size_t batchSize = config.batchSize > 0 ? config.batchSize : count;
+            std::array<float, PIXELS> weightErrors = {};
+            std::array<bool, PIXELS> marked = {};
+            vector<uint16_t> touched;
+            touched.reserve(PIXELS);
+
+            TrainingReport report = {{}, 0, false};
+            int bestScore = std::numeric_limits<int>::max();
+            int epochsWithoutImprovement = 0;
+            std::array<std::array<float, Columns>, Rows> bestWeights = weights;
+            float bestBias = bias;
+
+            for (int epoch = 0; epoch < config.epochs; epoch++) {
+                METRIC_TIMER(TIMER_TRAINING_EPOCH);
+                shuffle_indices(order, shuffler);
+                EpochStats stats = {0, 0, -1};
+                for (size_t start = 0; start < order.size(); start += batchSize) {
+                    size_t stop = std::min(order.size(), start + batchSize);
+                    float biasError = 0;
+                    for (size_t k = start; k < stop; k++) {
+                        const auto &inputValues = input(order[k]);
+                        float output = activation_function(inputValues);
+                        int expectedValue = expected(order[k]);
+                        int error = expectedValue - static_cast<int>(round(output));
+                        stats.loss += (expectedValue - output) * (expectedValue - output);
+                        if (error != 0) {
+                            stats.errors++;
+                            inputValues.for_each_active([&](int index) {
+                                if (!marked[index]) {
+                                    marked[index] = true;
+                                    touched.push_back(index);
+                                };
+                                weightErrors[index] += error;
+                            });
+                            biasError += error;
+                        };
+                    };
+                    // Si ningún patrón del lote tuvo error, los pesos no cambian.
+                    if (biasError != 0 || std::any_of(touched.begin(), touched.end(), [&](uint16_t index) { return weightErrors[index] != 0; })) {
+                        adjust_sparse(weightErrors, touched, biasError, stop - start);
+                        METRIC_ADD(COUNTER_TRAINING_UPDATES, 1);
+                    };
+                    for (uint16_t index : touched) {
+                        weightErrors[index] = 0;
+                        marked[index] = false;
+                    };
+                    touched.clear();
+                };
+                stats.loss /= std::max<size_t>(count, 1);
+                METRIC_ADD(COUNTER_TRAINING_PATTERNS, count);
+                METRIC_ADD(COUNTER_TRAINING_ERRORS, stats.errors);
+                stats.validationErrors = validate();
+                report.epochs.push_back(stats);
+                report.converged = stats.errors == 0;
+
+                if (config.patience > 0) {
+                    int score = stats.validationErrors >= 0 ? stats.validationErrors : stats.errors;
+                    if (score < bestScore) {
+                        bestScore = score;
+                        report.bestEpoch = epoch + 1;
+                        bestWeights = weights;
+                        bestBias = bias;
+                        epochsWithoutImprovement = 0;
+                    } else if (++epochsWithoutImprovement >= config.patience) {
+                        break;
+                    };
+                };
+                if (report.converged) {
+                    break;
+                };
+            };
+
+            if (config.patience > 0 && report.bestEpoch < static_cast<int>(report.epochs.size())) {
+                weights = bestWeights;
+                bias = bestBias;
+            } else {
+                report.bestEpoch = report.epochs.size();
+            };
+            return report;
+        };
+
+        /**
+         * @brief Método utilizado para entrenar la neurona con un mini-lote de muestras generadas al vuelo (ver 
+         * AugmentationStream). Aplica la Regla Delta promediada del lote, como training, sobre los píxeles tocados.
+         * 
+         * @param samples Arreglo de muestras (caracter y clase) del lote.
+         * @param count Número de muestras del lote.
+         * @param classIndex Parámetro de tipo entero con la clase que reconoce esta neurona.
+        */
+        template <typename SampleType>
+        void training_batch(const SampleType *samples, size_t count, int classIndex) {
+            METRIC_TIMER(TIMER_TRAINING_BATCH);
+            std::array<float, PIXELS> weightErrors;
+            std::array<bool, PIXELS> marked = {};
+            vector<uint16_t> touched;
+            touched.reserve(PIXELS);
+            float biasError = 0;
+            for (size_t k = 0; k < count; k++) {
+                int outputValue = round(activation_function(samples[k].glyph));
+                int error = (samples[k].label == classIndex) - outputValue;
+                if (error != 0) {
+                    METRIC_ADD(COUNTER_TRAINING_ERRORS, 1);
+                    samples[k].glyph.for_each_active([&](int index) {
+                        if (!marked[index]) {
+                            marked[index] = true;
+                            weightErrors[index] = 0;
+                            touched.push_back(index);
+                        };
+                        weightErrors[index] += error;
+                    });
+                    biasError += error;
+                };
+            };
+            METRIC_ADD(COUNTER_TRAINING_PATTERNS, count);
+            if (biasError != 0 || !touched.empty()) {
+                adjust_sparse(weightErrors, touched, biasError, count);
+                METRIC_ADD(COUNTER_TRAINING_UPDATES, 1);
+            };
+        };
+
+        // MÉTODOS DE UTILIDAD DEL PERCEPTRON
+
+        /**
+         * @brief Método utilizado para inicializar el vector de pesos de la neurona aleatoriamente.
+         * 
+         * @param random Parámetro de tipo generador (por defecto, el generador global).
+        */
+        void initialize_weights(mt19937 &random = generator) {
+            uniform_real_distribution<> distribution(dist.param());
+            for (int i = 0; i < Rows; i++) {
+                for (int j = 0; j < Columns; j++) {
+                    weights[i][j] = distribution(random);
+                };
+            };
+        };
+
+        /**
+         * @brief Método utilizado para inicializar el valor del bias (o sesgo ) de la neurona aleatoriamente.
+         * 
+         * @param random Parámetro de tipo generador (por defecto, el generador global).
+        */
+        void initialize_bias(mt19937 &random = generator) {
+            uniform_real_distribution<> distribution(dist.param());
+            bias = distribution(random);
+        };
+
+        /**
+         * @brief Método utilizado para mostrar el vector de pesos de la neurona en la consola.
+        */
+        void show_weights() const {
+            for (const std::array<float, Columns> &weight : weights) {
+                for (float w : weight) {
+                    cout << w << ", ";
+                };
+                cout << "\n";
+            };
+        };
+
+        /**
+         * @brief Método utilizado para retornar el vector de pesos de la neurona en una cadena de caracteres.
+         * 
+         * @return Cadena de caracteres que representan la matriz de pesos y el bias (o sesgo) de la neurona.
+        */
+        string weights_to_string() const {
+            string result = "";
+            for (const std::array<float, Columns> &weight : weights) {
+                string row = "";
+                for (float w : weight) {
+                    row += to_string(w) + " ";
+                };
+                row = row.substr(0, row.length() - 1);
+                result += row + "\n";
+            };
+            string bias_str = to_string(bias);
+            result += bias_str + "\n\n";
+            return result;
+        };
+
+        // SETTERS
+
+        /**
+         * @brief Método utilizado para asignar una nueva matriz de pesos (leída de la base de conocimiento) a la neurona. 
+         * Las posiciones que falten en la matriz se dejan en cero.
+        */
+        void set_weights(const vector<vector<float>> &newWeights) {
+            for (int i = 0; i < Rows; i++) {
+                for (int j = 0; j < Columns; j++) {
+                    bool present = i < static_cast<int>(newWeights.size()) && j < static_cast<int>(newWeights[i].size());
+                    weights[i][j] = present ? newWeights[i][j] : 0;
+                };
+            };
+        };
+
+        /**
+         * @brief Método utilizado para asignar un nuevo sesgo (o bias) a la neurona.
+        */
+        void set_bias(float newBias) {
+            bias = newBias;
+        };
+};
+
+/**
+ * @brief Perceptron de las vocales (entrada de 16x10).
+*/
+using Perceptron = BasicPerceptron<ROWS_NUM, COLUMNS_NUM>;
+
+/**
+ * @brief Clase BasicNeuralNetwork que modela una red neuronal de Classes perceptrones simples.
+ * 
+ * Se utiliza para analizar el problema planteado en el enunciado: identificar o reconocer
+ * letras vocales minúsculas (a, e, i, o, u), a través de una matriz de entrada. La salida 
+ * de la red neuronal es el índice de la neurona ganadora entre las Classes neuronas. Las dimensiones 
+ * de la entrada y el número de clases son parámetros de plantilla, así que la misma red sirve para 
+ * otras resoluciones (por ejemplo, dígitos de 32x20) sin tocar las constantes globales.
+*/
+template <int Rows, int Columns, int Classes>
+class BasicNeuralNetwork {
+    public:
+        static constexpr int ROWS = Rows;
+        static constexpr int COLUMNS = Columns;
+        static constexpr int CLASSES = Classes;
+        using GlyphType = BasicGlyph<Rows, Columns>;
+        using PatternType = BasicPattern<Rows, Columns>;
+        using PerceptronType = BasicPerceptron<Rows, Columns>;
+        using Scores = std::array<float, Classes>;
+
+        std::array<PerceptronType, Classes> perceptrons;
+        // Cambia cada vez que se cargan o se entrenan los pesos (ver BasicRecognitionCache); es atómica porque la
+        // tabla la lee desde otros hilos
+        std::atomic<uint64_t> version;
+
+        /**
+         * @brief Guarda que avanza la versión al empezar a escribir los pesos y otra vez al terminar (también si se 
+         * sale por una excepción), como un seqlock: un resultado calculado a medio cambio queda con una versión que 
+         * ya no vale cuando el cambio termina.
+        */
+        struct WeightsUpdate {
+            std::atomic<uint64_t> &version;
+
+            WeightsUpdate(std::atomic<uint64_t> &aVersion) : version(aVersion) {
+                version++;
+            };
+
+            ~WeightsUpdate() {
+                version++;
+            };
+        };
+
+        /**
+         * @brief Constructor de la clase BasicNeuralNetwork. Inicializa aleatoriamente los Classes perceptrones.
+        */
+        BasicNeuralNetwork() {
+            version = 0;
+            for (int i = 0; i < Classes; i++) {
+                perceptrons[i] = PerceptronType(LEARNING_RATE, 42);
+            };
+        }
+
+        /**
+         * @brief Constructor de la clase BasicNeuralNetwork con razón de aprendizaje y semilla propias. Los pesos 
+         * iniciales salen de un generador local, así que varias redes pueden crearse y entrenarse a la vez en el 
+         * mismo proceso y cada una depende solo de su semilla.
+         * 
+         * @param aLearningRate Parámetro de tipo flotante con la razón de aprendizaje de todas las neuronas.
+         * @param aSeed Parámetro de tipo entero con la semilla de los pesos iniciales.
+        */
+        BasicNeuralNetwork(float aLearningRate, unsigned int aSeed) {
+            version = 0;
+            mt19937 random(aSeed);
+            for (int i = 0; i < Classes; i++) {
+                perceptrons[i] = PerceptronType(aLearningRate, random);
+            };
+        }
+
+        /**
+         * @brief Constructor de copia de la clase BasicNeuralNetwork (std::atomic no se copia sola).
+        */
+        BasicNeuralNetwork(const BasicNeuralNetwork &other) : perceptrons(other.perceptrons) {
+            version = other.version.load();
+        };
+
+        /**
+         * @brief Operador de asignación de la clase BasicNeuralNetwork. La versión avanza más allá de las dos redes, 
+         * así que las entradas de la tabla calculadas con los pesos anteriores dejan de coincidir.
+        */
+        BasicNeuralNetwork &operator=(const BasicNeuralNetwork &other) {
+            perceptrons = other.perceptrons;
+            version = std::max(version.load(), other.version.load()) + 1;
+            return *this;
+        };
+
+        /**
+         * @brief Método utilizado para procesar un patrón específico con la red neuronal.
+         * 
+         * @param inputValues Parámetro de tipo GlyphType que representa la entrada de la red neuronal.
+         * @param output Parámetro de tipo Scores (arreglo de Classes números de coma flotante) donde se escriben las 
+         * salidas de la función de activación de cada neurona.
+        */
+        void process_input(const GlyphType &inputValues, Scores &output) const {
+            METRIC_TIMER(TIMER_PROCESS_INPUT);
+            for (int i = 0; i < Classes; i++) {
+                output[i] = perceptrons[i].activation_function(inputValues);
+            };
+        };
+
+        /**
+         * @brief Método utilizado para procesar un patrón específico con la red neuronal.
+         * 
+         * @param inputValues Parámetro de tipo GlyphType que representa la entrada de la red neuronal.
+         * 
+         * @return Arreglo de números de coma flotante (salidas de la función de activación de cada neurona de la red neuronal).
+        */
+        Scores process_input(const GlyphType &inputValues) const {
+            Scores output;
+            process_input(inputValues, output);
+            return output;
+        };
+
+        /**
+         * @brief Método utilizado para entrenar a la red neuronal con un conjunto de patrones. Como cada perceptron es 
+         * un clasificador uno contra todos independiente de los demás, cada uno se entrena en su propio hilo, por 
+         * épocas y mini-lotes (ver Perceptron::training). El resultado solo depende de la configuración y de los 
+         * pesos iniciales, no del orden en que terminan los hilos.
+         * 
+         * @param patterns Parámetro de tipo vector de patrones (PatternType) o conjunto de datos (BasicPatternDataset 
+         * o una vista) con las entradas y sus salidas esperadas. Se recibe por referencia y lo comparten todos los hilos.
+         * @param config Parámetro de tipo TrainingConfig con las épocas, el tamaño de lote, la semilla y la paciencia.
+         * @param validation Parámetro de tipo puntero al conjunto de validación (nullptr = sin validación). Cada 
+         * neurona lo evalúa al final de cada época para quedarse con su mejor época.
+         * 
+         * @return Arreglo con el TrainingReport de cada neurona.
+        */
+        template <typename PatternsType, typename ValidationType = PatternsType>
+        std::array<TrainingReport, Classes> training(const PatternsType &patterns, const TrainingConfig &config,
+                                                     const ValidationType *validation = nullptr) {
+            WeightsUpdate update(version);
+            std::array<TrainingReport, Classes> reports;
+            vector<std::thread> threads;
+            for (int i = 0; i < Classes; i++) {
+                threads.emplace_back([this, &patterns, &config, &reports, validation, i]() {
+                    reports[i] = perceptrons[i].training(patterns, i, config, validation);
+                });
+            };
+            for (std::thread &thread : threads) {
+                thread.join();
+            };
+            return reports;
+        };
+
+        /**
+         * @brief Método utilizado para entrenar a la red neuronal con un flujo de muestras (por ejemplo, 
+         * AugmentationStream). Se consumen mini-lotes hasta que el flujo se agota y cada neurona se ajusta con el 
+         * mismo lote; la memoria usada no depende del número total de muestras.
+         * 
+         * @param stream Parámetro de tipo flujo con un método pop(muestras, máximo) que devuelve 0 al terminar.
+         * @param batchSize Parámetro de tipo entero con el tamaño del mini-lote.
+        */
+        template <typename Stream>
+        void training_stream(Stream &stream, int batchSize) {
+            WeightsUpdate update(version);
+            vector<typename Stream::SampleType> batch(std::max(batchSize, 1));
+            size_t count;
+            while ((count = stream.pop(batch.data(), batch.size())) > 0) {
+                for (int i = 0; i < Classes; i++) {
+                    perceptrons[i].training_batch(batch.data(), count, i);
+                };
+            };
+        };
+
+        /**
+         * @brief Método utilizado para identificar o reconocer la matriz de entrada a través de la red neuronal 
+         * previamente entrenada.
+         * 
+         * @param inputValues Parámetro de tipo GlyphType que representa la entrada de la red neuronal.
+         * @param output Parámetro de tipo Scores donde quedan las salidas de cada neurona.
+         * 
+         * @return Número entero (índice de la vocal reconocida, o -1 si ninguna neurona responde). No se registra 
+         * en las métricas.
+        */
+        int resolve(const GlyphType &inputValues, Scores &output) const {
+            process_input(inputValues, output);
             return competition(output);
         };
 
         /**
-         * @brief Método utilizado para determinar que perceptron debe responder de acuerdo a la competencia 
-         * entre ellos. La respuesta debe sobrepasar un mínimo valor esperado y, luego, el perceptron con el 
-         * mejor acercamiento responderá. 
-         * 
-         * @param results Parámetro de tipo vector de números de coma flotante que representa los acercamientos 
-         * de cada neurona de la red neuronal.
-         * 
-         * @return Vector de números enteros (vectores canónicos [respuesta única] o vector nulo [sin respuesta]).
+         * @brief Método utilizado para identificar o reconocer la matriz de entrada a través de la red neuronal 
+         * previamente entrenada.
+         * 
+         * @param inputValues Parámetro de tipo GlyphType que representa la entrada de la red neuronal.
+         * 
+         * @return Número entero (índice de la vocal reconocida, o -1 si ninguna neurona responde).
+        */
+        int resolve(const GlyphType &inputValues) const {
+            Scores output;
+            return resolve(inputValues, output);
+        };
+
+        /**
+         * @brief Método utilizado para determinar que perceptron debe responder de acuerdo a la competencia 
+         * entre ellos. La respuesta debe sobrepasar un mínimo valor esperado y, luego, el perceptron con el 
+         * mejor acercamiento responderá. 
+         * 
+         * @param results Parámetro de tipo Scores que representa los acercamientos de cada neurona de la red neuronal.
+         * @param threshold Parámetro de tipo número de coma flotante con el mínimo valor esperado (MIN_OUTPUT).
+         * 
+         * @return Número entero (posición del 1 en el vector canónico [respuesta única] o -1 para el vector 
+         * nulo [sin respuesta]).
+        */
+        int competition(const Scores &results, float threshold = MIN_OUTPUT) const {
+            METRIC_TIMER(TIMER_COMPETITION);
+            int index = -1;
+            float min_output = threshold;
+            for (int i = 0; i < Classes; i++) {
+                if (results[i] > min_output) {
+                    min_output = results[i];
+                    index = i;
+                };
+            };
+            return index;
+        };
+
+        /**
+         * @brief Método utilizado para mostrar la respuesta de la red neuronal en la consola.
+         * 
+         * @param output Parámetro de tipo entero que representa la salida de la red neuronal (índice de la vocal o -1).
+        */
+        string show_results(int output) const {
+            const char *vowels[] = {"a", "e", "i", "o", "u"};
+            if (output >= 0 && output < 5 && Classes == 5) {
+                return string("Esto es una vocal ") + vowels[output] + ".";
+            };
+            if (output >= 0 && output < Classes) {
+                return "Esto es la clase " + to_string(output) + ".";
+            };
+            return "No reconozco esta letra.";
+        };
+
+        // KNOWLEDGE BASE
+
+        /**
+         * @brief Método utilizado para importar la base de conocimiento de la red neuronal. Acepta el formato de 
+         * texto (.txt) y el formato binario (ver KnowledgeBaseHeader); el formato se detecta por la firma del archivo.
+         * 
+         * @param filename Parámetro de tipo cadena de caracteres con el nombre del archivo.
+        */
+        void import_knowledge_base(const string &filename = "base.txt") {
+            METRIC_TIMER(TIMER_KNOWLEDGE_BASE);
+            METRIC_ADD(COUNTER_KNOWLEDGE_BASE_LOADS, 1);
+            WeightsUpdate update(version);
+            FileManager fileManager(filename, "read");
+            if (is_binary_knowledge_base(fileManager.content.data, fileManager.content.size)) {
+                const KnowledgeBaseHeader *header = check_binary_knowledge_base(fileManager.content, Rows, Columns, Classes);
+                // El búfer del archivo no garantiza la alineación de Lane: se lee como floats (alineados a 4 bytes)
+                const float *weights = reinterpret_cast<const float *>(fileManager.content.data + sizeof(KnowledgeBaseHeader));
+                const float *biases = weights + PerceptronType::PIXELS * header->lanes * SIMD_LANES;
+                for (int c = 0; c < Classes; c++) {
+                    PerceptronType &perceptron = perceptrons[c];
+                    for (int index = 0; index < PerceptronType::PIXELS; index++) {
+                        perceptron.weights[index / Columns][index % Columns] =
+                            weights[(index * header->lanes + c / SIMD_LANES) * SIMD_LANES + c % SIMD_LANES];
+                    };
+                    perceptron.set_bias(biases[c]);
+                };
+                return;
+            };
+
+            for (PerceptronType &perceptron : perceptrons) {
+                vector<vector<float>> weights = fileManager.parse_float_matrix(Rows);
+                float bias = fileManager.parse_float();
+                fileManager.line_break();
+
+                perceptron.set_weights(weights);
+                perceptron.set_bias(bias);
+            }
+        };
+
+        /**
+         * @brief Método utilizado para exportar la base de conocimiento de la red neuronal a tarvés de un .txt.
+         * 
+         * @param filename Parámetro de tipo cadena de caracteres con el nombre del archivo.
+        */
+        void export_knowledge_base(const string &filename = "base.txt") const {
+            FileManager fileManager(filename, "write");
+
+            for (const PerceptronType &perceptron : perceptrons) {
+                string perceptron_info = perceptron.weights_to_string();
+                fileManager.write(perceptron_info);
+            };
+        };
+};
+
+/**
+ * @brief Red neuronal de las vocales: caracteres de 16x10 y cinco clases (a, e, i, o, u).
+*/
+using NeuralNetwork = BasicNeuralNetwork<ROWS_NUM, COLUMNS_NUM, CLASSES_NUM>;
+
+/**
+ * @brief Clase BasicIncrementalScorer que reconoce una secuencia de caracteres parecidos entre sí (ruido del 
+ * escáner, aumentos de datos) reutilizando las entradas netas del caracter anterior: solo se suman o restan los 
+ * pesos de los píxeles que cambiaron. Si cambian más píxeles de los que tiene encendidos el caracter nuevo, o tras 
+ * REFRESH_INTERVAL actualizaciones seguidas (para no acumular error de redondeo), se recalcula todo.
+*/
+template <int Rows, int Columns, int Classes>
+class BasicIncrementalScorer {
+    public:
+        static constexpr int REFRESH_INTERVAL = 64;
+        using NetworkType = BasicNeuralNetwork<Rows, Columns, Classes>;
+        using GlyphType = BasicGlyph<Rows, Columns>;
+        using Scores = typename NetworkType::Scores;
+
+        const NetworkType &network;
+        GlyphType previous;
+        Scores netInputs;
+        int updates;
+        bool primed;
+
+        /**
+         * @brief Constructor de la clase BasicIncrementalScorer.
+         * 
+         * @param aNetwork Parámetro de tipo BasicNeuralNetwork con la base de conocimiento ya cargada. No debe 
+         * cambiar mientras se use el evaluador (o se debe llamar a reset).
+        */
+        BasicIncrementalScorer(const NetworkType &aNetwork) : network(aNetwork) {
+            reset();
+        };
+
+        /**
+         * @brief Método utilizado para olvidar el caracter anterior (el siguiente se calcula completo).
+        */
+        void reset() {
+            updates = 0;
+            primed = false;
+        };
+
+        /**
+         * @brief Método utilizado para calcular las salidas de todas las neuronas para el siguiente caracter.
+         * 
+         * @param inputValues Parámetro de tipo GlyphType con el caracter.
+         * @param output Parámetro de tipo Scores donde se escriben las salidas de la función sigmoide.
+         * 
+         * @return Número de píxeles que cambiaron respecto al caracter anterior (-1 si se recalculó todo).
+        */
+        int score(const GlyphType &inputValues, Scores &output) {
+            GlyphType changed;
+            int changes = 0;
+            for (int w = 0; w < GlyphType::WORDS; w++) {
+                changed.words[w] = inputValues.words[w] ^ previous.words[w];
+                changes += count_bits(changed.words[w]);
+            };
+
+            if (!primed || updates >= REFRESH_INTERVAL || changes > inputValues.count()) {
+                for (int c = 0; c < Classes; c++) {
+                    netInputs[c] = network.perceptrons[c].net_input(inputValues);
+                };
+                updates = 0;
+                primed = true;
+                changes = -1;
+            } else {
+                changed.for_each_active([&](int index) {
+                    int row = index / Columns;
+                    int column = index % Columns;
+                    float sign = inputValues.test(index) ? 1.0f : -1.0f;
+                    for (int c = 0; c < Classes; c++) {
+                        netInputs[c] += sign * network.perceptrons[c].weights[row][column];
+                    };
+                });
+                updates++;
+            };
+            previous = inputValues;
+
+            for (int c = 0; c < Classes; c++) {
+                output[c] = 1 / (1 + exp(-netInputs[c]));
+            };
+            return changes;
+        };
+
+        /**
+         * @brief Método utilizado para reconocer el siguiente caracter de la secuencia.
+         * 
+         * @return Número entero (índice de la vocal reconocida, o -1 si ninguna neurona responde).
+        */
+        int resolve(const GlyphType &inputValues) {
+            Scores output;
+            score(inputValues, output);
+            return network.competition(output);
+        };
+};
+
+using IncrementalScorer = BasicIncrementalScorer<ROWS_NUM, COLUMNS_NUM, CLASSES_NUM>;
+
+/**
+ * @brief Núcleo escalar de la red fusionada: acumula, para cada caracter del lote, los pesos de sus píxeles 
+ * encendidos en bloques de SIMD_LANES neuronas. Es la versión de respaldo para procesadores sin SSE/AVX.
+ * 
+ * Parámetros de plantilla: GlyphType (tipo de caracter), Lanes (bloques de SIMD_LANES neuronas por píxel) y 
+ * Classes (número real de neuronas, sin relleno).
+ * 
+ * @param weights Matriz de pesos fusionada (GlyphType::PIXELS filas de Lanes bloques).
+ * @param biases Vector de sesgos fusionado (Lanes bloques).
+ * @param glyphs Arreglo de caracteres del lote.
+ * @param count Número de caracteres del lote.
+ * @param netInputs Arreglo de count x Classes donde se escriben las sumas ponderadas.
+*/
+template <typename GlyphType, int Lanes, int Classes>
+void fused_kernel_scalar(const Lane *weights, const Lane *biases, const GlyphType *glyphs, size_t count,
+                         float *netInputs) {
+    for (size_t g = 0; g < count; g++) {
+        for (int l = 0; l < Lanes; l++) {
+            Lane acc = {};
+            glyphs[g].for_each_active([&](int index) {
+                const Lane &row = weights[index * Lanes + l];
+                for (int k = 0; k < SIMD_LANES; k++) {
+                    acc.values[k] += row.values[k];
+                };
+            });
+            int valid = std::min(SIMD_LANES, Classes - l * SIMD_LANES);
+            for (int k = 0; k < valid; k++) {
+                netInputs[g * Classes + l * SIMD_LANES + k] = acc.values[k] + biases[l].values[k];
+            };
+        };
+    };
+};
+
+#if defined(PERCEPTRON_X86_SIMD)
+/**
+ * @brief Núcleo SSE de la red fusionada (dos registros de 4 neuronas por bloque). Mismos parámetros que 
+ * fused_kernel_scalar.
+*/
+template <typename GlyphType, int Lanes, int Classes>
+__attribute__((target("sse2")))
+void fused_kernel_sse(const Lane *weights, const Lane *biases, const GlyphType *glyphs, size_t count,
+                      float *netInputs) {
+    for (size_t g = 0; g < count; g++) {
+        for (int l = 0; l < Lanes; l++) {
+            __m128 low = _mm_setzero_ps();
+            __m128 high = _mm_setzero_ps();
+            // Recorrido explícito de bits: una lambda no heredaría el atributo target de esta función.
+            for (int w = 0; w < GlyphType::WORDS; w++) {
+                uint32_t bits = glyphs[g].words[w];
+                while (bits != 0) {
+                    const float *row = weights[(w * 32 + lowest_bit(bits)) * Lanes + l].values;
+                    low = _mm_add_ps(low, _mm_load_ps(row));
+                    high = _mm_add_ps(high, _mm_load_ps(row + 4));
+                    bits &= bits - 1;
+                };
+            };
+            Lane acc;
+            _mm_store_ps(acc.values, _mm_add_ps(low, _mm_load_ps(biases[l].values)));
+            _mm_store_ps(acc.values + 4, _mm_add_ps(high, _mm_load_ps(biases[l].values + 4)));
+            int valid = std::min(SIMD_LANES, Classes - l * SIMD_LANES);
+            for (int k = 0; k < valid; k++) {
+                netInputs[g * Classes + l * SIMD_LANES + k] = acc.values[k];
+            };
+        };
+    };
+};
+
+/**
+ * @brief Núcleo AVX de la red fusionada (un registro de 8 neuronas por bloque). Mismos parámetros que 
+ * fused_kernel_scalar.
+*/
+template <typename GlyphType, int Lanes, int Classes>
+__attribute__((target("avx")))
+void fused_kernel_avx(const Lane *weights, const Lane *biases, const GlyphType *glyphs, size_t count,
+                      float *netInputs) {
+    for (size_t g = 0; g < count; g++) {
+        for (int l = 0; l < Lanes; l++) {
+            __m256 acc = _mm256_setzero_ps();
+            for (int w = 0; w < GlyphType::WORDS; w++) {
+                uint32_t bits = glyphs[g].words[w];
+                while (bits != 0) {
+                    const float *row = weights[(w * 32 + lowest_bit(bits)) * Lanes + l].values;
+                    acc = _mm256_add_ps(acc, _mm256_load_ps(row));
+                    bits &= bits - 1;
+                };
+            };
+            Lane result;
+            _mm256_store_ps(result.values, _mm256_add_ps(acc, _mm256_load_ps(biases[l].values)));
+            int valid = std::min(SIMD_LANES, Classes - l * SIMD_LANES);
+            for (int k = 0; k < valid; k++) {
+                netInputs[g * Classes + l * SIMD_LANES + k] = result.values[k];
+            };
+        };
+    };
+};
+#endif
+
+/**
+ * @brief Clase BasicFusedNetwork que agrupa los pesos de todas las neuronas de una BasicNeuralNetwork en una sola 
+ * matriz contigua y alineada para reconocer lotes de caracteres.
+ * 
+ * La matriz se guarda por píxel: la fila p contiene el peso del píxel p para cada neurona, rellenada hasta un 
+ * múltiplo de SIMD_LANES. Como las entradas son binarias, el producto matriz-lote se reduce a sumar, por cada 
+ * píxel encendido, una fila completa en un registro vectorial (AVX o SSE según el procesador, con respaldo 
+ * escalar). Las sumas quedan contiguas, de modo que la sigmoide y la competencia recorren memoria secuencial.
+*/
+template <int Rows, int Columns, int Classes>
+class BasicFusedNetwork {
+    public:
+        static constexpr int PIXELS = Rows * Columns;
+        static constexpr int CLASSES = Classes;
+        static constexpr int LANES = (Classes + SIMD_LANES - 1) / SIMD_LANES;
+        using GlyphType = BasicGlyph<Rows, Columns>;
+        using NetworkType = BasicNeuralNetwork<Rows, Columns, Classes>;
+        typedef void (*Kernel)(const Lane *, const Lane *, const GlyphType *, size_t, float *);
+
+        std::array<Lane, PIXELS * LANES> weights;
+        std::array<Lane, LANES> biases;
+        Kernel kernel;
+
+        /**
+         * @brief Constructor de la clase BasicFusedNetwork. Copia los pesos y sesgos de la red neuronal dada.
+         * 
+         * @param network Parámetro de tipo BasicNeuralNetwork con la base de conocimiento ya cargada.
+        */
+        BasicFusedNetwork(const NetworkType &network) {
+            weights.fill(Lane());
+            biases.fill(Lane());
+            for (int c = 0; c < Classes; c++) {
+                const typename NetworkType::PerceptronType &perceptron = network.perceptrons[c];
+                int lane = c / SIMD_LANES;
+                int slot = c % SIMD_LANES;
+                for (int i = 0; i < Rows; i++) {
+                    for (int j = 0; j < Columns; j++) {
+                        int index = i * Columns + j;
+                        weights[index * LANES + lane].values[slot] = perceptron.weights[i][j];
+                    };
+                };
+                biases[lane].values[slot] = perceptron.bias;
+            };
+            kernel = select_kernel();
+        };
+
+        /**
+         * @brief Constructor de la clase BasicFusedNetwork a partir de una base de conocimiento binaria. Los pesos se 
+         * copian tal cual desde el archivo proyectado en memoria, sin parsear texto.
+         * 
+         * @param filename Parámetro de tipo cadena de caracteres con el nombre del archivo .bin.
+        */
+        BasicFusedNetwork(const string &filename) {
+            MappedFile content;
+            if (!content.open(filename)) {
+                throw std::runtime_error("No se pudo abrir la base de conocimiento " + filename + ".");
+            };
+            check_binary_knowledge_base(content, Rows, Columns, Classes);
+            // El búfer del archivo no garantiza la alineación de Lane: los bytes se copian sin leerlos como Lane
+            const char *payload = content.data + sizeof(KnowledgeBaseHeader);
+            std::memcpy(weights.data(), payload, sizeof(Lane) * PIXELS * LANES);
+            std::memcpy(biases.data(), payload + sizeof(Lane) * PIXELS * LANES, sizeof(Lane) * LANES);
+            kernel = select_kernel();
+        };
+
+        /**
+         * @brief Método utilizado para guardar los pesos en una base de conocimiento binaria.
+         * 
+         * @param filename Parámetro de tipo cadena de caracteres con el nombre del archivo .bin.
+        */
+        void save(const string &filename) const {
+            write_binary_knowledge_base(filename, Rows, Columns, Classes, weights.data(), biases.data());
+        };
+
+        /**
+         * @brief Método utilizado para elegir el núcleo más rápido que soporta el procesador en ejecución.
+         * 
+         * @return Puntero al núcleo (AVX, SSE o escalar).
+        */
+        static Kernel select_kernel() {
+#if defined(PERCEPTRON_X86_SIMD)
+            if (__builtin_cpu_supports("avx")) {
+                return fused_kernel_avx<GlyphType, LANES, Classes>;
+            };
+            if (__builtin_cpu_supports("sse2")) {
+                return fused_kernel_sse<GlyphType, LANES, Classes>;
+            };
+#endif
+            return fused_kernel_scalar<GlyphType, LANES, Classes>;
+        };
+
+        /**
+         * @brief Método utilizado para procesar un lote de caracteres con todas las neuronas a la vez.
+         * 
+         * @param glyphs Arreglo de caracteres del lote.
+         * @param count Número de caracteres del lote.
+         * @param scores Arreglo de count x Classes donde se escriben las salidas de la función sigmoide, 
+         * un caracter a continuación del otro.
+        */
+        void process_batch(const GlyphType *glyphs, size_t count, float *scores) const {
+            kernel(weights.data(), biases.data(), glyphs, count, scores);
+            size_t total = count * Classes;
+            for (size_t i = 0; i < total; i++) {
+                scores[i] = 1 / (1 + exp(-scores[i]));
+            };
+        };
+
+        /**
+         * @brief Método utilizado para determinar que neurona responde ante las salidas de un caracter. Sigue la 
+         * misma regla que BasicNeuralNetwork::competition.
+         * 
+         * @param results Arreglo de Classes salidas de la función sigmoide.
+         * 
+         * @return Número entero (índice de la vocal reconocida, o -1 si ninguna neurona responde).
+        */
+        int competition(const float *results) const {
+            int index = -1;
+            float min_output = MIN_OUTPUT;
+            for (int i = 0; i < Classes; i++) {
+                if (results[i] > min_output) {
+                    min_output = results[i];
+                    index = i;
+                };
+            };
+            return index;
+        };
+
+        /**
+         * @brief Método utilizado para reconocer un lote de caracteres.
+         * 
+         * @param glyphs Arreglo de caracteres del lote.
+         * @param count Número de caracteres del lote.
+         * @param scores Arreglo de count x Classes para las salidas de la función sigmoide.
+         * @param answers Arreglo de count enteros donde se escribe la respuesta de cada caracter.
+        */
+        void resolve_batch(const GlyphType *glyphs, size_t count, float *scores, int *answers) const {
+            METRIC_TIMER(TIMER_RESOLVE_BATCH);
+            process_batch(glyphs, count, scores);
+            for (size_t g = 0; g < count; g++) {
+                answers[g] = competition(scores + g * Classes);
+                METRIC_RECOGNIZED(scores + g * Classes, Classes, answers[g]);
+            };
+        };
+};
+
+/**
+ * @brief Red fusionada de las vocales (16x10, cinco clases).
+*/
+using FusedNetwork = BasicFusedNetwork<ROWS_NUM, COLUMNS_NUM, CLASSES_NUM>;
+
+/**
+ * @brief Clase BasicRecognitionCache que guarda, para los últimos caracteres reconocidos, las salidas de las 
+ * neuronas y la respuesta de la competencia, para no repetir el cálculo cuando un caracter idéntico vuelve a 
+ * aparecer (por ejemplo, en formularios escaneados).
+ * 
+ * La tabla tiene un tamaño fijo y se reparte en SHARDS fragmentos, cada uno con su propio cerrojo y sus contadores 
+ * de aciertos y fallos, de modo que varios hilos pueden consultarla a la vez sin competir por un único cerrojo. El 
+ * hash del caracter elige el fragmento y la posición dentro de él; si la posición está ocupada por otro caracter, el 
+ * nuevo lo reemplaza. Cada entrada recuerda la versión de la base de conocimiento con la que se calculó: cuando 
+ * import_knowledge_base (o un entrenamiento) cambia la red, las entradas anteriores dejan de coincidir sin tener que 
+ * recorrer la tabla.
+ * 
+ * Los fallos se calculan con una copia fusionada de la red (BasicFusedNetwork), que se reconstruye cuando cambia la 
+ * versión; resolve_batch junta todos los fallos de un lote en una sola llamada a resolve_batch de esa copia, así que 
+ * las respuestas son las mismas que las de la red fusionada sin tabla.
+ * 
+ * Los pesos de la red no son atómicos: no debe cargarse ni entrenarse mientras otro hilo consulta la tabla. La 
+ * versión avanza antes y después de cada cambio (ver BasicNeuralNetwork::WeightsUpdate), de modo que lo que se 
+ * calcule con pesos a medio escribir deja de coincidir en cuanto el cambio termina.
+*/
+template <int Rows, int Columns, int Classes>
+class BasicRecognitionCache {
+    public:
+        static constexpr int CLASSES = Classes;
+        static constexpr int SHARDS = 16;
+        using NetworkType = BasicNeuralNetwork<Rows, Columns, Classes>;
+        using FusedType = BasicFusedNetwork<Rows, Columns, Classes>;
+        using GlyphType = BasicGlyph<Rows, Columns>;
+        using Scores = typename NetworkType::Scores;
+
+        struct Entry {
+            GlyphType glyph;
+            Scores scores;
+            int answer;
+            uint64_t version;
+            bool used;
+        };
+
+        struct alignas(64) Shard {
+            std::mutex mutex;
+            vector<Entry> entries;
+            size_t hits;
+            size_t misses;
+        };
+
+        const NetworkType &network;
+        mutable std::array<Shard, SHARDS> shards;
+        // Copia fusionada de la red y versión con la que se hizo; solo se tocan con fusedMutex
+        mutable std::mutex fusedMutex;
+        mutable std::shared_ptr<const FusedType> fused;
+        mutable uint64_t fusedVersion;
+
+        /**
+         * @brief Constructor de la clase BasicRecognitionCache.
+         * 
+         * @param aNetwork Parámetro de tipo BasicNeuralNetwork cuyas respuestas se guardan.
+         * @param aCapacity Parámetro de tipo entero con el número máximo de caracteres guardados.
+        */
+        BasicRecognitionCache(const NetworkType &aNetwork, size_t aCapacity = 65536) : network(aNetwork) {
+            size_t perShard = std::max<size_t>(1, (aCapacity + SHARDS - 1) / SHARDS);
+            for (Shard &shard : shards) {
+                shard.entries.assign(perShard, Entry{});
+                shard.hits = 0;
+                shard.misses = 0;
+            };
+            fusedVersion = 0;
+        };
+
+        BasicRecognitionCache(const BasicRecognitionCache &) = delete;
+        BasicRecognitionCache &operator=(const BasicRecognitionCache &) = delete;
+
+        /**
+         * @brief Método utilizado para obtener la copia fusionada de la red con la versión dada, reconstruyéndola si 
+         * la red cambió. Quien la recibe la conserva aunque otro hilo la reemplace.
+        */
+        std::shared_ptr<const FusedType> fused_network(uint64_t version) const {
+            std::lock_guard<std::mutex> lock(fusedMutex);
+            if (!fused || fusedVersion != version) {
+                fused = std::make_shared<const FusedType>(network);
+                fusedVersion = version;
+            };
+            return fused;
+        };
+
+        /**
+         * @brief Método utilizado para buscar un caracter en una posición de un fragmento (con su cerrojo tomado) y 
+         * contar el acierto o el fallo.
+         * 
+         * @return Valor booleano (verdadero si estaba; entonces scores y answer quedan con lo guardado).
+        */
+        bool find(Shard &shard, size_t slot, const GlyphType &glyph, uint64_t version, float *scores, int &answer) const {
+            const Entry &entry = shard.entries[slot];
+            if (entry.used && entry.version == version && entry.glyph == glyph) {
+                shard.hits++;
+                std::copy(entry.scores.begin(), entry.scores.end(), scores);
+                answer = entry.answer;
+                METRIC_RECOGNIZED(scores, Classes, answer);
+                return true;
+            };
+            shard.misses++;
+            return false;
+        };
+
+        /**
+         * @brief Método utilizado para guardar un resultado en una posición de un fragmento (con su cerrojo tomado).
+        */
+        void store(Shard &shard, size_t slot, const GlyphType &glyph, const float *scores, int answer,
+                   uint64_t version) const {
+            Entry &entry = shard.entries[slot];
+            entry.glyph = glyph;
+            std::copy(scores, scores + Classes, entry.scores.begin());
+            entry.answer = answer;
+            entry.version = version;
+            entry.used = true;
+        };
+
+        /**
+         * @brief Método utilizado para reconocer un caracter, consultando primero la tabla. En un fallo, las salidas 
+         * se calculan fuera del cerrojo y luego se guardan.
+         * 
+         * @param inputValues Parámetro de tipo GlyphType con el caracter.
+         * @param output Parámetro de tipo Scores donde quedan las salidas de cada neurona.
+         * 
+         * @return Número entero (índice de la vocal reconocida, o -1 si ninguna neurona responde).
+        */
+        int resolve(const GlyphType &inputValues, Scores &output) const {
+            uint64_t hash = inputValues.hash();
+            Shard &shard = shards[hash % SHARDS];
+            size_t slot = (hash / SHARDS) % shard.entries.size();
+            uint64_t version = network.version.load(std::memory_order_acquire);
+            int answer;
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                if (find(shard, slot, inputValues, version, output.data(), answer)) {
+                    return answer;
+                };
+            }
+
+            fused_network(version)->resolve_batch(&inputValues, 1, output.data(), &answer);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            store(shard, slot, inputValues, output.data(), answer, version);
+            return answer;
+        };
+
+        /**
+         * @brief Método utilizado para reconocer un caracter, consultando primero la tabla.
+         * 
+         * @return Número entero (índice de la vocal reconocida, o -1 si ninguna neurona responde).
+        */
+        int resolve(const GlyphType &inputValues) const {
+            Scores output;
+            return resolve(inputValues, output);
+        };
+
+        /**
+         * @brief Método utilizado para reconocer un lote de caracteres con la misma interfaz que 
+         * BasicFusedNetwork::resolve_batch, para usar la tabla desde batch_recognition. Los caracteres se ordenan 
+         * por fragmento, así que cada cerrojo se toma una vez para buscar y otra para guardar, y todos los fallos se 
+         * calculan juntos con la red fusionada.
+        */
+        void resolve_batch(const GlyphType *glyphs, size_t count, float *scores, int *answers) const {
+            uint64_t version = network.version.load(std::memory_order_acquire);
+            vector<uint64_t> hashes(count);
+            std::array<size_t, SHARDS + 1> starts = {};
+            for (size_t g = 0; g < count; g++) {
+                hashes[g] = glyphs[g].hash();
+                starts[hashes[g] % SHARDS + 1]++;
+            };
+            for (int s = 0; s < SHARDS; s++) {
+                starts[s + 1] += starts[s];
+            };
+            vector<size_t> order(count);
+            std::array<size_t, SHARDS + 1> positions = starts;
+            for (size_t g = 0; g < count; g++) {
+                order[positions[hashes[g] % SHARDS]++] = g;
+            };
+
+            // Los fallos quedan ordenados por fragmento, igual que order
+            vector<size_t> missing;
+            for (int s = 0; s < SHARDS; s++) {
+                if (starts[s] == starts[s + 1]) {
+                    continue;
+                };
+                Shard &shard = shards[s];
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                for (size_t k = starts[s]; k < starts[s + 1]; k++) {
+                    size_t g = order[k];
+                    size_t slot = (hashes[g] / SHARDS) % shard.entries.size();
+                    if (!find(shard, slot, glyphs[g], version, scores + g * Classes, answers[g])) {
+                        missing.push_back(g);
+                    };
+                };
+            };
+            if (missing.empty()) {
+                return;
+            };
+
+            vector<GlyphType> pending(missing.size());
+            for (size_t m = 0; m < missing.size(); m++) {
+                pending[m] = glyphs[missing[m]];
+            };
+            vector<float> pendingScores(missing.size() * Classes);
+            vector<int> pendingAnswers(missing.size());
+            fused_network(version)->resolve_batch(pending.data(), pending.size(), pendingScores.data(),
+                                                  pendingAnswers.data());
+
+            for (size_t m = 0; m < missing.size();) {
+                Shard &shard = shards[hashes[missing[m]] % SHARDS];
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                do {
+                    size_t g = missing[m];
+                    const float *output = pendingScores.data() + m * Classes;
+                    std::copy(output, output + Classes, scores + g * Classes);
+                    answers[g] = pendingAnswers[m];
+                    store(shard, (hashes[g] / SHARDS) % shard.entries.size(), glyphs[g], output, answers[g], version);
+                    m++;
+                } while (m < missing.size() && &shards[hashes[missing[m]] % SHARDS] == &shard);
+            };
+        };
+
+        /**
+         * @brief Método utilizado para vaciar la tabla y poner los contadores en cero.
+        */
+        void clear() {
+            for (Shard &shard : shards) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                for (Entry &entry : shard.entries) {
+                    entry.used = false;
+                };
+                shard.hits = 0;
+                shard.misses = 0;
+            };
+        };
+
+        size_t hits() const {
+            size_t total = 0;
+            for (Shard &shard : shards) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                total += shard.hits;
+            };
+            return total;
+        };
+
+        size_t misses() const {
+            size_t total = 0;
+            for (Shard &shard : shards) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                total += shard.misses;
+            };
+            return total;
+        };
+};
+
+using RecognitionCache = BasicRecognitionCache<ROWS_NUM, COLUMNS_NUM, CLASSES_NUM>;
+
+/**
+ * @brief Clase BasicQuantizedNetwork que reconoce caracteres con pesos enteros (int8_t o int16_t) en lugar de 
+ * float. Todos los pesos comparten una escala calibrada (el mayor peso en valor absoluto se lleva al máximo del 
+ * tipo), de modo que las sumas de todas las neuronas se pueden comparar entre sí sin volver a coma flotante.
+ * 
+ * Como la sigmoide es creciente, la competencia (salida > MIN_OUTPUT y la mayor gana) se decide directamente 
+ * sobre la entrada neta: basta comparar la suma entera con el logit de MIN_OUTPUT, precalculado y cuantizado en 
+ * cutoff. Así el reconocimiento no llama a exp ni hace operaciones de coma flotante.
+*/
+template <int Rows, int Columns, int Classes, typename Weight>
+class BasicQuantizedNetwork {
+    public:
+        static constexpr int PIXELS = Rows * Columns;
+        static constexpr int CLASSES = Classes;
+        static constexpr int LIMIT = std::numeric_limits<Weight>::max();
+        using GlyphType = BasicGlyph<Rows, Columns>;
+        using NetworkType = BasicNeuralNetwork<Rows, Columns, Classes>;
+
+        std::array<std::array<Weight, Classes>, PIXELS> weights;
+        std::array<int32_t, Classes> biases;
+        float scale;
+        int32_t cutoff;
+
+        /**
+         * @brief Constructor de la clase BasicQuantizedNetwork. Calibra la escala y cuantiza los pesos y sesgos de 
+         * la red neuronal dada (los sesgos se guardan en 32 bits con la misma escala).
+         * 
+         * @param network Parámetro de tipo BasicNeuralNetwork con la base de conocimiento ya cargada.
+        */
+        BasicQuantizedNetwork(const NetworkType &network) {
+            float maxWeight = 0;
+            for (const typename NetworkType::PerceptronType &perceptron : network.perceptrons) {
+                for (int i = 0; i < Rows; i++) {
+                    for (int j = 0; j < Columns; j++) {
+                        maxWeight = std::max(maxWeight, std::fabs(perceptron.weights[i][j]));
+                    };
+                };
+            };
+            scale = maxWeight > 0 ? maxWeight / LIMIT : 1;
+
+            for (int c = 0; c < Classes; c++) {
+                const typename NetworkType::PerceptronType &perceptron = network.perceptrons[c];
+                for (int i = 0; i < Rows; i++) {
+                    for (int j = 0; j < Columns; j++) {
+                        long value = std::lround(perceptron.weights[i][j] / scale);
+                        weights[i * Columns + j][c] = static_cast<Weight>(std::max(-static_cast<long>(LIMIT), std::min(static_cast<long>(LIMIT), value)));
+                    };
+                };
+                biases[c] = static_cast<int32_t>(std::lround(perceptron.bias / scale));
+            };
+
+            // sigmoide(x) > MIN_OUTPUT  <=>  x > log(MIN_OUTPUT / (1 - MIN_OUTPUT))
+            cutoff = static_cast<int32_t>(std::floor(std::log(MIN_OUTPUT / (1 - MIN_OUTPUT)) / scale));
+        };
+
+        /**
+         * @brief Método utilizado para calcular las entradas netas (enteras) de todas las neuronas para un caracter.
+         * 
+         * @param inputValues Parámetro de tipo GlyphType con el caracter.
+         * @param sums Arreglo de Classes enteros donde se escriben las entradas netas en unidades de scale.
+        */
+        void net_inputs(const GlyphType &inputValues, int32_t *sums) const {
+            for (int c = 0; c < Classes; c++) {
+                sums[c] = biases[c];
+            };
+            inputValues.for_each_active([&](int index) {
+                const Weight *row = weights[index].data();
+                for (int c = 0; c < Classes; c++) {
+                    sums[c] += row[c];
+                };
+            });
+        };
+
+        /**
+         * @brief Método utilizado para determinar que neurona responde. Sigue la regla de 
+         * BasicNeuralNetwork::competition, comparando las entradas netas contra cutoff.
+         * 
+         * @return Número entero (índice de la vocal reconocida, o -1 si ninguna neurona responde).
+        */
+        int competition(const int32_t *sums) const {
+            int index = -1;
+            int32_t min_output = cutoff;
+            for (int i = 0; i < Classes; i++) {
+                if (sums[i] > min_output) {
+                    min_output = sums[i];
+                    index = i;
+                };
+            };
+            return index;
+        };
+
+        /**
+         * @brief Método utilizado para reconocer un caracter.
+         * 
+         * @return Número entero (índice de la vocal reconocida, o -1 si ninguna neurona responde).
+        */
+        int resolve(const GlyphType &inputValues) const {
+            int32_t sums[Classes];
+            net_inputs(inputValues, sums);
+            return competition(sums);
+        };
+
+        /**
+         * @brief Método utilizado para reconocer un lote de caracteres, con la misma interfaz que 
+         * BasicFusedNetwork::resolve_batch.
+         * 
+         * @param glyphs Arreglo de caracteres del lote.
+         * @param count Número de caracteres del lote.
+         * @param scores Arreglo de count x Classes donde se escriben las entradas netas reconstruidas 
+         * (suma entera por scale), no las salidas de la sigmoide.
+         * @param answers Arreglo de count enteros donde se escribe la respuesta de cada caracter.
+        */
+        void resolve_batch(const GlyphType *glyphs, size_t count, float *scores, int *answers) const {
+            METRIC_TIMER(TIMER_RESOLVE_BATCH);
+            int32_t sums[Classes];
+            for (size_t g = 0; g < count; g++) {
+                net_inputs(glyphs[g], sums);
+                for (int c = 0; c < Classes; c++) {
+                    scores[g * Classes + c] = sums[c] * scale;
+                };
+                answers[g] = competition(sums);
+                // Las salidas son entradas netas, no sigmoides: no entran en el histograma
+                METRIC_RECOGNIZED(nullptr, Classes, answers[g]);
+            };
+        };
+};
+
+/**
+ * @brief Redes cuantizadas de las vocales (16x10, cinco clases) con pesos de 8 y de 16 bits.
+*/
+using QuantizedNetwork8 = BasicQuantizedNetwork<ROWS_NUM, COLUMNS_NUM, CLASSES_NUM, int8_t>;
+using QuantizedNetwork16 = BasicQuantizedNetwork<ROWS_NUM, COLUMNS_NUM, CLASSES_NUM, int16_t>;
+
+/**
+ * @brief Clase BasicLayeredNetwork que implementa una red multicapa: una capa oculta de hidden neuronas sigmoide y 
+ * una capa de salida de Classes neuronas sigmoide, entrenada con retropropagación (entropía cruzada) por 
+ * mini-lotes. Con hidden = 0 es la red de una capa de BasicNeuralNetwork: mismas salidas y misma competencia.
+ * 
+ * Todos los parámetros viven en un único buffer contiguo, en este orden:
+ * - pesos ocultos: PIXELS filas de hidden valores (una fila por píxel, como en FusedNetwork, para que un píxel 
+ * encendido sume una fila contigua);
+ * - sesgos ocultos: hidden valores;
+ * - pesos de salida: inputs() filas de Classes valores (inputs() = hidden, o PIXELS si no hay capa oculta);
+ * - sesgos de salida: Classes valores.
+ * Los gradientes usan la misma disposición, así que la actualización es un solo recorrido lineal.
+*/
+template <int Rows, int Columns, int Classes>
+class BasicLayeredNetwork {
+    public:
+        static constexpr int PIXELS = Rows * Columns;
+        static constexpr int CLASSES = Classes;
+        using GlyphType = BasicGlyph<Rows, Columns>;
+        using NetworkType = BasicNeuralNetwork<Rows, Columns, Classes>;
+
+        int hidden;
+        vector<float> parameters;
+        size_t hiddenBiases;
+        size_t outputWeights;
+        size_t outputBiases;
+
+        /**
+         * @brief Constructor de la clase BasicLayeredNetwork con pesos aleatorios (uniformes en +-sqrt(6 / (n + m)) 
+         * por capa).
+         * 
+         * @param aHidden Parámetro de tipo entero con el número de neuronas ocultas (0 = una sola capa).
+         * @param seed Parámetro de tipo entero con la semilla de los pesos iniciales.
+        */
+        BasicLayeredNetwork(int aHidden, unsigned int seed) {
+            layout(aHidden);
+            mt19937 random(seed);
+            float hiddenLimit = std::sqrt(6.0f / (PIXELS + std::max(hidden, 1)));
+            float outputLimit = std::sqrt(6.0f / (inputs() + Classes));
+            std::uniform_real_distribution<float> hiddenWeight(-hiddenLimit, hiddenLimit);
+            std::uniform_real_distribution<float> outputWeight(-outputLimit, outputLimit);
+            for (size_t i = 0; i < hiddenBiases; i++) {
+                parameters[i] = hiddenWeight(random);
+            };
+            for (size_t i = outputWeights; i < outputBiases; i++) {
+                parameters[i] = outputWeight(random);
+            };
+        };
+
+        /**
+         * @brief Constructor de la clase BasicLayeredNetwork a partir de una red de una capa (hidden = 0).
+         * 
+         * @param network Parámetro de tipo BasicNeuralNetwork con la base de conocimiento ya cargada.
+        */
+        BasicLayeredNetwork(const NetworkType &network) {
+            layout(0);
+            for (int c = 0; c < Classes; c++) {
+                const typename NetworkType::PerceptronType &perceptron = network.perceptrons[c];
+                for (int index = 0; index < PIXELS; index++) {
+                    parameters[outputWeights + index * Classes + c] = perceptron.weights[index / Columns][index % Columns];
+                };
+                parameters[outputBiases + c] = perceptron.bias;
+            };
+        };
+
+        /**
+         * @brief Constructor de la clase BasicLayeredNetwork a partir de una base de conocimiento: binaria de la 
+         * versión 2 (con capa oculta), o cualquier base de una capa (texto o binaria de la versión 1).
+         * 
+         * @param filename Parámetro de tipo cadena de caracteres con el nombre del archivo.
+        */
+        BasicLayeredNetwork(const string &filename) {
+            MappedFile content;
+            if (!content.open(filename)) {
+                throw std::runtime_error("No se pudo abrir la base de conocimiento " + filename + ".");
+            };
+            if (is_binary_knowledge_base(content.data, content.size) &&
+                reinterpret_cast<const KnowledgeBaseHeader *>(content.data)->version == KNOWLEDGE_BASE_LAYERED_VERSION) {
+                const KnowledgeBaseHeader *header = check_layered_knowledge_base(content, Rows, Columns, Classes);
+                layout(header->hidden);
+                const float *payload = reinterpret_cast<const float *>(content.data + sizeof(KnowledgeBaseHeader));
+                std::copy(payload, payload + parameters.size(), parameters.begin());
+                return;
+            };
+            NetworkType network;
+            network.import_knowledge_base(filename);
+            *this = BasicLayeredNetwork(network);
+        };
+
+        /**
+         * @brief Método utilizado para dimensionar el buffer de parámetros y calcular dónde empieza cada bloque.
+        */
+        void layout(int aHidden) {
+            hidden = std::max(aHidden, 0);
+            hiddenBiases = static_cast<size_t>(PIXELS) * hidden;
+            outputWeights = hiddenBiases + hidden;
+            outputBiases = outputWeights + static_cast<size_t>(inputs()) * Classes;
+            parameters.assign(outputBiases + Classes, 0.0f);
+        };
+
+        /**
+         * @brief Método utilizado para obtener el número de entradas de la capa de salida.
+        */
+        int inputs() const {
+            return hidden > 0 ? hidden : PIXELS;
+        };
+
+        /**
+         * @brief Método utilizado para calcular la salida de la red para un bloque de caracteres, capa por capa: las 
+         * entradas netas ocultas de todo el bloque (una fila contigua por píxel encendido), la sigmoide sobre el 
+         * bloque entero y la capa de salida recorriendo cada fila de pesos una sola vez para todo el bloque. Cada 
+         * salida suma en el mismo orden que si el caracter se procesara solo.
+         * 
+         * @param glyphs Arreglo de count caracteres.
+         * @param count Número de caracteres del bloque.
+         * @param activations Arreglo de count x hidden valores donde se escriben las salidas de la capa oculta.
+         * @param scores Arreglo de count x Classes valores donde se escriben las salidas de la función sigmoide.
+        */
+        void forward_batch(const GlyphType *glyphs, size_t count, float *activations, float *scores) const {
+            const float *values = parameters.data();
+            // scores acumula primero las entradas netas de la capa de salida
+            std::fill(scores, scores + count * Classes, 0.0f);
+            if (hidden == 0) {
+                for (size_t g = 0; g < count; g++) {
+                    float *netInputs = scores + g * Classes;
+                    glyphs[g].for_each_active([&](int index) {
+                        const float *row = values + outputWeights + static_cast<size_t>(index) * Classes;
+                        for (int c = 0; c < Classes; c++) {
+                            netInputs[c] += row[c];
+                        };
+                    });
+                };
+            } else {
+                std::fill(activations, activations + count * hidden, 0.0f);
+                for (size_t g = 0; g < count; g++) {
+                    float *hiddenInputs = activations + g * hidden;
+                    glyphs[g].for_each_active([&](int index) {
+                        const float *row = values + static_cast<size_t>(index) * hidden;
+                        for (int j = 0; j < hidden; j++) {
+                            hiddenInputs[j] += row[j];
+                        };
+                    });
+                };
+                for (size_t g = 0; g < count; g++) {
+                    float *hiddenOutputs = activations + g * hidden;
+                    for (int j = 0; j < hidden; j++) {
+                        hiddenOutputs[j] = 1 / (1 + exp(-(hiddenOutputs[j] + values[hiddenBiases + j])));
+                    };
+                };
+                for (int j = 0; j < hidden; j++) {
+                    const float *row = values + outputWeights + static_cast<size_t>(j) * Classes;
+                    for (size_t g = 0; g < count; g++) {
+                        float activation = activations[g * hidden + j];
+                        float *netInputs = scores + g * Classes;
+                        for (int c = 0; c < Classes; c++) {
+                            netInputs[c] += activation * row[c];
+                        };
+                    };
+                };
+            };
+            for (size_t g = 0; g < count; g++) {
+                for (int c = 0; c < Classes; c++) {
+                    scores[g * Classes + c] = 1 / (1 + exp(-(scores[g * Classes + c] + values[outputBiases + c])));
+                };
+            };
+        };
+
+        /**
+         * @brief Método utilizado para determinar que neurona responde. Sigue la regla de 
+         * BasicNeuralNetwork::competition.
+        */
+        int competition(const float *results) const {
+            int index = -1;
+            float min_output = MIN_OUTPUT;
+            for (int i = 0; i < Classes; i++) {
+                if (results[i] > min_output) {
+                    min_output = results[i];
+                    index = i;
+                };
+            };
+            return index;
+        };
+
+        /**
+         * @brief Método utilizado para reconocer un lote de caracteres, con la misma interfaz que 
+         * BasicFusedNetwork::resolve_batch. Se procesa en bloques de BLOCK_SIZE caracteres (ver forward_batch).
+         * 
+         * @param glyphs Arreglo de caracteres del lote.
+         * @param count Número de caracteres del lote.
+         * @param scores Arreglo de count x Classes para las salidas de la función sigmoide.
+         * @param answers Arreglo de count enteros donde se escribe la respuesta de cada caracter.
+        */
+        void resolve_batch(const GlyphType *glyphs, size_t count, float *scores, int *answers) const {
+            METRIC_TIMER(TIMER_RESOLVE_BATCH);
+            const size_t BLOCK_SIZE = 256;
+            vector<float> activations(std::min(count, BLOCK_SIZE) * hidden);
+            for (size_t begin = 0; begin < count; begin += BLOCK_SIZE) {
+                size_t end = std::min(count, begin + BLOCK_SIZE);
+                forward_batch(glyphs + begin, end - begin, activations.data(), scores + begin * Classes);
+            };
+            for (size_t g = 0; g < count; g++) {
+                answers[g] = competition(scores + g * Classes);
+                METRIC_RECOGNIZED(scores + g * Classes, Classes, answers[g]);
+            };
+        };
+
+        /**
+         * @brief Método utilizado para reconocer un caracter, sin registrarlo en las métricas.
+         * 
+         * @return Número entero (índice de la vocal reconocida, o -1 si ninguna neurona responde).
+        */
+        int resolve(const GlyphType &inputValues) const {
+            vector<float> activations(hidden);
+            float scores[Classes];
+            forward_batch(&inputValues, 1, activations.data(), scores);
+            return competition(scores);
+        };
+
+        /**
+         * @brief Método utilizado para acumular el gradiente de la entropía cruzada de un bloque de caracteres con 
+         * sus clases. Como forward_batch, recorre cada fila de pesos de salida una sola vez para todo el bloque; cada 
+         * gradiente suma los caracteres en el orden del bloque.
+         * 
+         * @param glyphs Arreglo de count caracteres.
+         * @param labels Arreglo de count clases esperadas (-1 = ninguna).
+         * @param count Número de caracteres del bloque.
+         * @param gradients Buffer con la misma disposición que parameters donde se suma el gradiente.
+         * @param activations Arreglo de trabajo de count x hidden valores.
+         * @param deltas Arreglo de trabajo de count x hidden valores.
+         * @param outputDeltas Arreglo de trabajo de count x Classes valores.
+        */
+        void backward_batch(const GlyphType *glyphs, const int *labels, size_t count, float *gradients,
+                            float *activations, float *deltas, float *outputDeltas) const {
+            const float *values = parameters.data();
+            forward_batch(glyphs, count, activations, outputDeltas);
+
+            // Con sigmoide y entropía cruzada, el error de cada salida es (s - y)
+            for (size_t g = 0; g < count; g++) {
+                for (int c = 0; c < Classes; c++) {
+                    outputDeltas[g * Classes + c] -= c == labels[g] ? 1.0f : 0.0f;
+                    gradients[outputBiases + c] += outputDeltas[g * Classes + c];
+                };
+            };
+
+            if (hidden == 0) {
+                for (size_t g = 0; g < count; g++) {
+                    const float *errors = outputDeltas + g * Classes;
+                    glyphs[g].for_each_active([&](int index) {
+                        float *row = gradients + outputWeights + static_cast<size_t>(index) * Classes;
+                        for (int c = 0; c < Classes; c++) {
+                            row[c] += errors[c];
+                        };
+                    });
+                };
+                return;
+            };
+
+            for (int j = 0; j < hidden; j++) {
+                const float *row = values + outputWeights + static_cast<size_t>(j) * Classes;
+                float *gradientRow = gradients + outputWeights + static_cast<size_t>(j) * Classes;
+                for (size_t g = 0; g < count; g++) {
+                    float activation = activations[g * hidden + j];
+                    const float *errors = outputDeltas + g * Classes;
+                    float sum = 0;
+                    for (int c = 0; c < Classes; c++) {
+                        gradientRow[c] += activation * errors[c];
+                        sum += row[c] * errors[c];
+                    };
+                    deltas[g * hidden + j] = sum * activation * (1 - activation);
+                    gradients[hiddenBiases + j] += deltas[g * hidden + j];
+                };
+            };
+            for (size_t g = 0; g < count; g++) {
+                const float *hiddenDeltas = deltas + g * hidden;
+                glyphs[g].for_each_active([&](int index) {
+                    float *row = gradients + static_cast<size_t>(index) * hidden;
+                    for (int j = 0; j < hidden; j++) {
+                        row[j] += hiddenDeltas[j];
+                    };
+                });
+            };
+        };
+
+        /**
+         * @brief Método utilizado para entrenar la red con retropropagación por mini-lotes: en cada época se baraja 
+         * el orden y, por cada lote, se copian sus caracteres a un bloque contiguo, se acumula el gradiente de todo el 
+         * bloque (backward_batch) y se aplica su promedio.
+         * 
+         * @param dataset Parámetro de tipo conjunto de datos con size(), glyph(i) y label(i).
+         * @param config Parámetro de tipo TrainingConfig con las épocas, el tamaño de lote y la semilla.
+         * @param learningRate Parámetro de tipo número de coma flotante con la razón de aprendizaje.
+        */
+        template <typename DatasetType>
+        void training(const DatasetType &dataset, const TrainingConfig &config, float learningRate) {
+            mt19937 shuffler(config.seed);
+            vector<int> order(dataset.size());
+            std::iota(order.begin(), order.end(), 0);
+            size_t batchSize = config.batchSize > 0 ? config.batchSize : std::max<size_t>(order.size(), 1);
+            vector<float> gradients(parameters.size());
+            vector<GlyphType> glyphs(batchSize);
+            vector<int> labels(batchSize);
+            vector<float> activations(batchSize * hidden);
+            vector<float> deltas(batchSize * hidden);
+            vector<float> outputDeltas(batchSize * Classes);
+
+            for (int epoch = 0; epoch < config.epochs; epoch++) {
+                METRIC_TIMER(TIMER_TRAINING_EPOCH);
+                shuffle_indices(order, shuffler);
+                for (size_t start = 0; start < order.size(); start += batchSize) {
+                    size_t stop = std::min(order.size(), start + batchSize);
+                    std::fill(gradients.begin(), gradients.end(), 0.0f);
+                    for (size_t k = start; k < stop; k++) {
+                        glyphs[k - start] = dataset.glyph(order[k]);
+                        labels[k - start] = dataset.label(order[k]);
+                    };
+                    backward_batch(glyphs.data(), labels.data(), stop - start, gradients.data(), activations.data(),
+                                   deltas.data(), outputDeltas.data());
+                    float rate = learningRate / (stop - start);
+                    float *values = parameters.data();
+                    const float *gradient = gradients.data();
+                    for (size_t i = 0; i < parameters.size(); i++) {
+                        values[i] -= rate * gradient[i];
+                    };
+                    METRIC_ADD(COUNTER_TRAINING_PATTERNS, stop - start);
+                    METRIC_ADD(COUNTER_TRAINING_UPDATES, 1);
+                };
+            };
+        };
+
+        /**
+         * @brief Método utilizado para guardar la red en una base de conocimiento binaria: versión 1 (la de 
+         * FusedNetwork) si no tiene capa oculta y versión 2 si la tiene.
+         * 
+         * @param filename Parámetro de tipo cadena de caracteres con el nombre del archivo .bin.
+        */
+        void save(const string &filename) const {
+            if (hidden > 0) {
+                write_layered_knowledge_base(filename, Rows, Columns, Classes, hidden, parameters.data(), parameters.size());
+                return;
+            };
+            const int lanes = (Classes + SIMD_LANES - 1) / SIMD_LANES;
+            vector<Lane> weights(static_cast<size_t>(PIXELS) * lanes);
+            vector<Lane> biases(lanes);
+            for (int c = 0; c < Classes; c++) {
+                for (int index = 0; index < PIXELS; index++) {
+                    weights[index * lanes + c / SIMD_LANES].values[c % SIMD_LANES] = parameters[outputWeights + index * Classes + c];
+                };
+                biases[c / SIMD_LANES].values[c % SIMD_LANES] = parameters[outputBiases + c];
+            };
+            write_binary_knowledge_base(filename, Rows, Columns, Classes, weights.data(), biases.data());
+        };
+};
+
+/**
+ * @brief Red multicapa de las vocales (16x10, cinco clases).
+*/
+using LayeredNetwork = BasicLayeredNetwork<ROWS_NUM, COLUMNS_NUM, CLASSES_NUM>;
+
+/**
+ * @brief Clase ThreadPool que mantiene un grupo fijo de hilos para repartir trabajo independiente (por ejemplo, 
+ * lotes de caracteres que comparten una misma red de solo lectura).
+*/
+class ThreadPool {
+    public:
+        vector<std::thread> workers;
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable available;
+        std::condition_variable finished;
+        size_t pending;
+        bool stopping;
+
+        /**
+         * @brief Constructor de la clase ThreadPool.
+         * 
+         * @param aThreadsNumber Parámetro de tipo entero que indica cuántos hilos se crean. Si es menor que 1 se 
+         * usa el número de núcleos del equipo.
+        */
+        ThreadPool(int aThreadsNumber) {
+            pending = 0;
+            stopping = false;
+            if (aThreadsNumber < 1) {
+                aThreadsNumber = std::max(1u, std::thread::hardware_concurrency());
+            };
+            for (int i = 0; i < aThreadsNumber; i++) {
+                workers.emplace_back([this]() { worker_loop(); });
+            };
+        };
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        /**
+         * @brief Destructor de la clase ThreadPool. Termina las tareas pendientes y espera a los hilos.
+        */
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            available.notify_all();
+            for (std::thread &worker : workers) {
+                worker.join();
+            };
+        };
+
+        /**
+         * @brief Método utilizado para encolar una tarea.
+         * 
+         * @param task Parámetro de tipo función sin argumentos que se ejecutará en alguno de los hilos.
+        */
+        void submit(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                tasks.push_back(std::move(task));
+                pending++;
+            }
+            available.notify_one();
+        };
+
+        /**
+         * @brief Método utilizado para esperar a que terminen todas las tareas encoladas.
+        */
+        void wait() {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [this]() { return pending == 0; });
+        };
+
+        /**
+         * @brief Método utilizado para repartir el rango [0, count) en bloques de tamaño chunk entre los hilos y 
+         * esperar a que se procesen todos.
+         * 
+         * @param count Parámetro de tipo entero que indica el tamaño del rango.
+         * @param chunk Parámetro de tipo entero que indica el tamaño de cada bloque.
+         * @param body Parámetro de tipo función que recibe el inicio y el fin (exclusivo) de un bloque.
+        */
+        void parallel_for(size_t count, size_t chunk, const std::function<void(size_t, size_t)> &body) {
+            chunk = std::max<size_t>(1, chunk);
+            for (size_t begin = 0; begin < count; begin += chunk) {
+                size_t end = std::min(count, begin + chunk);
+                submit([&body, begin, end]() { body(begin, end); });
+            };
+            wait();
+        };
+
+        /**
+         * @brief Método que ejecuta cada hilo: toma tareas de la cola hasta que se destruye el grupo.
+        */
+        void worker_loop() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                    if (tasks.empty()) {
+                        return;
+                    };
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    pending--;
+                    if (pending == 0) {
+                        finished.notify_all();
+                    };
+                }
+            };
+        };
+};
+
+/**
+ * @brief Función que devuelve los valores esperados de cada vocal (vectores canónicos de tamaño CLASSES_NUM).
+ * 
+ * @return Vector de vectores de enteros: la fila i tiene un 1 en la posición i (a, e, i, o, u).
+*/
+vector<vector<int>> get_expected_values() {
+    // Valores esperados
+    vector<int> aExpected = {1, 0, 0, 0, 0};
+    vector<int> eExpected = {0, 1, 0, 0, 0};
+    vector<int> iExpected = {0, 0, 1, 0, 0};
+    vector<int> oExpected = {0, 0, 0, 1, 0};
+    vector<int> uExpected = {0, 0, 0, 0, 1};
+
+    return {aExpected, eExpected, iExpected, oExpected, uExpected};
+};
+
+/**
+ * @brief Clase AugmentationStream que genera, en hilos de trabajo, variantes aumentadas de los patrones de 
+ * entrenamiento y las entrega en orden a través de un búfer circular de tamaño fijo. La memoria no depende del 
+ * número total de muestras, y los hilos se adelantan hasta capacity muestras para que el entrenamiento no espere.
+ * 
+ * Cada muestra tiene un número de turno: el patrón de origen y la transformación salen de un generador sembrado 
+ * con (seed, turno), así que la secuencia es la misma con cualquier número de hilos.
+*/
+template <typename PatternType>
+class AugmentationStream {
+    public:
+        using GlyphType = typename PatternType::first_type;
+        using SampleType = AugmentedSample<GlyphType>;
+
+        const vector<PatternType> &patterns;
+        vector<int> labels;
+        AugmentationConfig config;
+        unsigned int seed;
+        size_t total;
+        vector<SampleType> slots;
+        vector<unsigned char> ready;
+        size_t nextTicket;
+        size_t consumed;
+        unsigned long long stalls;
+        bool stopping;
+        std::mutex mutex;
+        std::condition_variable produced;
+        std::condition_variable freed;
+        vector<std::thread> workers;
+
+        /**
+         * @brief Constructor de la clase AugmentationStream. Arranca los hilos de trabajo.
+         * 
+         * @param aPatterns Parámetro de tipo vector de patrones de origen (debe existir mientras dure el flujo).
+         * @param aConfig Parámetro de tipo AugmentationConfig.
+         * @param aTotal Parámetro de tipo entero con el número total de muestras a generar.
+         * @param capacity Parámetro de tipo entero con el tamaño del búfer circular.
+         * @param threadsNumber Parámetro de tipo entero con el número de hilos (0 = todos los núcleos).
+         * @param aSeed Parámetro de tipo entero con la semilla.
+        */
+        AugmentationStream(const vector<PatternType> &aPatterns, const AugmentationConfig &aConfig, size_t aTotal,
+                           size_t capacity, int threadsNumber, unsigned int aSeed) : patterns(aPatterns) {
+            config = aConfig;
+            total = aTotal;
+            seed = aSeed;
+            slots.resize(std::max<size_t>(capacity, 1));
+            ready.assign(slots.size(), 0);
+            nextTicket = 0;
+            consumed = 0;
+            stalls = 0;
+            stopping = false;
+            for (const PatternType &pattern : patterns) {
+                auto one = std::find(pattern.second.begin(), pattern.second.end(), 1);
+                labels.push_back(one != pattern.second.end() ? static_cast<int>(one - pattern.second.begin()) : -1);
+            };
+            if (threadsNumber < 1) {
+                threadsNumber = std::max(1u, std::thread::hardware_concurrency());
+            };
+            for (int i = 0; i < threadsNumber; i++) {
+                workers.emplace_back([this]() {
+                    worker_loop();
+                });
+            };
+        };
+
+        /**
+         * @brief Destructor de la clase AugmentationStream. Detiene y espera a los hilos de trabajo.
+        */
+        ~AugmentationStream() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            };
+            freed.notify_all();
+            for (std::thread &worker : workers) {
+                worker.join();
+            };
+        };
+
+        AugmentationStream(const AugmentationStream &) = delete;
+        AugmentationStream &operator=(const AugmentationStream &) = delete;
+
+        /**
+         * @brief Método utilizado para sacar las siguientes muestras del flujo, en orden.
+         * 
+         * @param output Arreglo donde se copian las muestras.
+         * @param maxCount Número máximo de muestras a sacar.
+         * 
+         * @return Número de muestras copiadas (0 cuando el flujo terminó).
+        */
+        size_t pop(SampleType *output, size_t maxCount) {
+            std::unique_lock<std::mutex> lock(mutex);
+            size_t count = 0;
+            while (count < maxCount && consumed < total) {
+                size_t slot = consumed % slots.size();
+                if (!ready[slot]) {
+                    stalls++;
+                    // Los huecos liberados en este mismo lote deben despertar a los hilos antes de esperar: si el
+                    // lote es mayor que el búfer, el hilo que produce la muestra pendiente espera uno de ellos
+                    freed.notify_all();
+                    produced.wait(lock, [this, slot]() { return ready[slot] != 0; });
+                };
+                output[count++] = slots[slot];
+                ready[slot] = 0;
+                consumed++;
+            };
+            lock.unlock();
+            freed.notify_all();
+            return count;
+        };
+
+        /**
+         * @brief Método utilizado para generar la muestra de un turno.
+        */
+        SampleType generate(size_t ticket) const {
+            uint32_t mixed = seed + 0x9E3779B9u * static_cast<uint32_t>(ticket + 1);
+            mixed = (mixed ^ (mixed >> 16)) * 0x85EBCA6Bu;
+            mixed = (mixed ^ (mixed >> 13)) * 0xC2B2AE35u;
+            std::minstd_rand random(mixed ^ (mixed >> 16));
+            size_t source = random() % patterns.size();
+            return {augment_glyph(patterns[source].first, config, random), labels[source]};
+        };
+
+        void worker_loop() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!stopping && nextTicket < total) {
+                size_t ticket = nextTicket++;
+                freed.wait(lock, [this, ticket]() { return stopping || ticket < consumed + slots.size(); });
+                if (stopping) {
+                    return;
+                };
+                lock.unlock();
+                SampleType sample = generate(ticket);
+                lock.lock();
+                slots[ticket % slots.size()] = sample;
+                ready[ticket % slots.size()] = 1;
+                produced.notify_all();
+            };
+        };
+};
+
+/**
+ * @brief Función que toma los patrones (a través de unos .txt de ejemplos) utilizados para 
+ * el entrenamiento de una red neuronal.
+ * 
+ * @param expectedValues Parámetro de tipo vector de vectores de enteros que representan los posibles
+ * valores esperados de los patrones (vocales).
+ * 
+ * @return Vector de patrones (entradas de la red y su salida esperada). Se devuelve por movimiento.
+*/
+vector<Pattern> get_patterns(const vector<vector<int>> &expectedValues) {
+    string path = "patterns/";
+    vector<string> files = {"ejemplosA.txt", "ejemplosE.txt", "ejemplosI.txt", "ejemplosO.txt", "ejemplosU.txt"};
+    vector<Pattern> patterns;
+    patterns.reserve(files.size() * PATTERNS_NUM);
+    for (size_t i = 0; i < files.size(); i++) {
+        FileManager fileManager(path + files[i], "read");
+        for (int j = 0; j < PATTERNS_NUM; j++) {
+            Glyph pattern = fileManager.parse_glyph();
+            fileManager.line_break();
+            patterns.emplace_back(pattern, expectedValues[i]);
+        };
+    };
+    return patterns;
+};
+
+/**
+ * @brief Clase BasicPatternDataset que guarda un conjunto de entrenamiento como estructura de arreglos: todos los 
+ * caracteres empaquetados en un único bloque contiguo y, aparte, la clase de cada uno como un índice de 16 bits 
+ * (-1 si no pertenece a ninguna). Con millones de caracteres no hay una reserva de memoria por patrón.
+*/
+template <int Rows, int Columns>
+class BasicPatternDataset {
+    public:
+        using GlyphType = BasicGlyph<Rows, Columns>;
+
+        vector<GlyphType> glyphs;
+        vector<int16_t> labels;
+
+        size_t size() const {
+            return glyphs.size();
+        };
+
+        const GlyphType &glyph(size_t index) const {
+            return glyphs[index];
+        };
+
+        int label(size_t index) const {
+            return labels[index];
+        };
+
+        /**
+         * @brief Método utilizado para añadir un caracter con su clase.
+        */
+        void add(const GlyphType &glyph, int label) {
+            glyphs.push_back(glyph);
+            labels.push_back(static_cast<int16_t>(label));
+        };
+
+        /**
+         * @brief Método utilizado para cargar los caracteres de un archivo .txt (matrices separadas por líneas en 
+         * blanco), todos de la misma clase. Se reserva espacio de antemano a partir del tamaño del archivo.
+         * 
+         * @param filename Parámetro de tipo cadena de caracteres con el nombre del archivo.
+         * @param label Parámetro de tipo entero con la clase de los caracteres.
+         * @param maxCount Parámetro de tipo entero con el máximo de caracteres a leer del archivo.
+         * 
+         * @return Número de caracteres cargados.
+        */
+        size_t load_file(const string &filename, int label, size_t maxCount = SIZE_MAX) {
+            FileManager fileManager(filename, "read");
+            // Cada caracter ocupa al menos Rows filas de Columns dígitos con su separador
+            size_t estimate = std::min(maxCount, fileManager.content.size / (Rows * Columns * 2) + 1);
+            glyphs.reserve(glyphs.size() + estimate);
+            labels.reserve(labels.size() + estimate);
+
+            size_t loaded = 0;
+            GlyphType glyph;
+            while (loaded < maxCount && fileManager.next_glyph(glyph)) {
+                add(glyph, label);
+                loaded++;
+            };
+            return loaded;
+        };
+
+        /**
+         * @brief Método utilizado para cargar una lista de archivos, cada uno con su clase.
+         * 
+         * @param files Parámetro de tipo vector de pares (nombre del archivo, clase).
+         * @param maxCount Parámetro de tipo entero con el máximo de caracteres a leer de cada archivo.
+        */
+        void load_files(const vector<pair<string, int>> &files, size_t maxCount = SIZE_MAX) {
+            for (const pair<string, int> &file : files) {
+                load_file(file.first, file.second, maxCount);
+            };
+        };
+};
+
+/**
+ * @brief Clase BasicDatasetView que presenta un conjunto de datos (o parte de él) en otro orden sin copiar los 
+ * caracteres: solo guarda las posiciones. Tiene la misma interfaz size(), glyph(i), label(i) que el conjunto.
+*/
+template <typename DatasetType>
+class BasicDatasetView {
+    public:
+        using GlyphType = typename DatasetType::GlyphType;
+
+        const DatasetType *dataset;
+        vector<uint32_t> order;
+
+        /**
+         * @brief Constructor de la clase BasicDatasetView. La vista empieza con todos los caracteres, en orden.
+        */
+        BasicDatasetView(const DatasetType &aDataset) {
+            dataset = &aDataset;
+            order.resize(dataset->size());
+            std::iota(order.begin(), order.end(), 0);
+        };
+
+        size_t size() const {
+            return order.size();
+        };
+
+        const GlyphType &glyph(size_t index) const {
+            return dataset->glyph(order[index]);
+        };
+
+        int label(size_t index) const {
+            return dataset->label(order[index]);
+        };
+
+        /**
+         * @brief Método utilizado para barajar el orden de la vista con el generador dado.
+        */
+        void shuffle(mt19937 &shuffler) {
+            shuffle_indices(order, shuffler);
+        };
+
+        /**
+         * @brief Método utilizado para obtener la vista de las posiciones [begin, end) de esta vista.
+        */
+        BasicDatasetView slice(size_t begin, size_t end) const {
+            BasicDatasetView result(*this);
+            begin = std::min(begin, order.size());
+            end = std::max(begin, std::min(end, order.size()));
+            result.order.assign(order.begin() + begin, order.begin() + end);
+            return result;
+        };
+};
+
+using PatternDataset = BasicPatternDataset<ROWS_NUM, COLUMNS_NUM>;
+using DatasetView = BasicDatasetView<PatternDataset>;
+
+/**
+ * @brief Función que carga los patrones de las vocales (patterns/ejemplosA..U.txt, PATTERNS_NUM por archivo) en un 
+ * conjunto de datos contiguo; la vocal i tiene la clase i.
+ * 
+ * @param path Parámetro de tipo cadena de caracteres con el directorio de los patrones.
+ * 
+ * @return Conjunto de datos con los patrones.
+*/
+PatternDataset get_pattern_dataset(const string &path = "patterns/") {
+    vector<string> files = {"ejemplosA.txt", "ejemplosE.txt", "ejemplosI.txt", "ejemplosO.txt", "ejemplosU.txt"};
+    PatternDataset dataset;
+    for (size_t i = 0; i < files.size(); i++) {
+        dataset.load_file(path + files[i], i, PATTERNS_NUM);
+    };
+    return dataset;
+};
+
+/**
+ * @brief Función que guarda la base de conocimiento de una red neuronal: en formato binario si el nombre del archivo 
+ * termina en .bin y en texto si no.
+*/
+void save_knowledge_base(const NeuralNetwork &neuralNetwork, const string &filename) {
+    if (filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".bin") == 0) {
+        FusedNetwork(neuralNetwork).save(filename);
+    } else {
+        neuralNetwork.export_knowledge_base(filename);
+    };
+};
+
+/**
+ * @brief Función que lee todos los caracteres (matrices 16x10 separadas por una línea en blanco) de un archivo .txt.
+ * 
+ * @param filename Parámetro de tipo cadena de caracteres que representa el nombre del archivo.
+ * 
+ * @return Vector de caracteres (Glyph) en el orden en que aparecen en el archivo.
+*/
+vector<Glyph> read_glyphs(const string &filename) {
+    METRIC_TIMER(TIMER_READ_GLYPHS);
+    vector<Glyph> glyphs;
+    FileManager fileManager(filename, "read");
+    Glyph glyph;
+    while (fileManager.next_glyph(glyph)) {
+        glyphs.push_back(glyph);
+    };
+    return glyphs;
+};
+
+/**
+ * @brief Función que lee un archivo completo en una cadena de caracteres (se usa para armar entradas sintéticas).
+*/
+string read_text(const string &filename) {
+    MappedFile content;
+    if (!content.open(filename)) {
+        return "";
+    };
+    return string(content.data, content.size);
+};
+
+/**
+ * @brief Función que compara el parser anterior (getline + istringstream + stoi/stof) con TextScanner sobre los 
+ * archivos de ejemplo, repetidos varias veces para simular archivos grandes.
+ * 
+ * @param factor Parámetro de tipo entero que indica cuántas veces se repiten los archivos de ejemplo.
+*/
+void benchmark_parsing(int factor) {
+    vector<string> sources = {"patterns/ejemplosA.txt", "patterns/ejemplosE.txt", "patterns/ejemplosI.txt",
+                              "patterns/ejemplosO.txt", "patterns/ejemplosU.txt", "input.txt"};
+    string glyphText;
+    string floatText;
+    string baseText = read_text("base.txt");
+    for (int r = 0; r < factor; r++) {
+        for (const string &source : sources) {
+            glyphText += read_text(source) + "\n\n";
+        };
+        floatText += baseText + "\n";
+    };
+
+    auto report = [](const string &name, size_t bytes, long items, double seconds) {
+        cout << name << ": " << items << " elementos, " << seconds << " s, "
+             << bytes / seconds / 1e6 << " MB/s\n";
+    };
+
+    // Parser anterior de matrices de ceros y unos.
+    auto start = std::chrono::steady_clock::now();
+    long legacyGlyphs = 0;
+    {
+        istringstream stream(glyphText);
+        string str_line;
+        while (getline(stream, str_line)) {
+            if (str_line.find_first_not_of(" \t\r") == string::npos) {
+                continue;
+            };
+            Glyph glyph;
+            for (int i = 0; i < ROWS_NUM; i++) {
+                if (i > 0) {
+                    getline(stream, str_line);
+                };
+                istringstream iss(str_line);
+                string token;
+                int j = 0;
+                while (iss >> token && j < COLUMNS_NUM) {
+                    glyph.set(i, j, stoi(token) != 0);
+                    j++;
+                };
+            };
+            legacyGlyphs += glyph.count() >= 0;
+        };
+    }
+    double legacyGlyphSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    long fastGlyphs = 0;
+    {
+        TextScanner scanner(glyphText.data(), glyphText.data() + glyphText.size());
+        Glyph glyph;
+        while (scanner.next_glyph(glyph)) {
+            fastGlyphs++;
+        };
+    }
+    double fastGlyphSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Parser anterior de números de coma flotante.
+    start = std::chrono::steady_clock::now();
+    long legacyFloats = 0;
+    float legacySum = 0;
+    {
+        istringstream stream(floatText);
+        string str_line;
+        while (getline(stream, str_line)) {
+            istringstream iss(str_line);
+            string token;
+            while (iss >> token) {
+                legacySum += stof(token);
+                legacyFloats++;
+            };
+        };
+    }
+    double legacyFloatSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    long fastFloats = 0;
+    float fastSum = 0;
+    {
+        TextScanner scanner(floatText.data(), floatText.data() + floatText.size());
+        while (!scanner.at_end()) {
+            for (float value : scanner.parse_float_row()) {
+                fastSum += value;
+                fastFloats++;
+            };
+        };
+    }
+    double fastFloatSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    report("matrices (getline/istringstream/stoi)", glyphText.size(), legacyGlyphs, legacyGlyphSeconds);
+    report("matrices (TextScanner)", glyphText.size(), fastGlyphs, fastGlyphSeconds);
+    report("flotantes (getline/istringstream/stof)", floatText.size(), legacyFloats, legacyFloatSeconds);
+    report("flotantes (TextScanner)", floatText.size(), fastFloats, fastFloatSeconds);
+    cout << "control: " << legacySum << " " << fastSum << "\n";
+};
+
+/**
+ * @brief Resultado de una fase medida por el arnés de medición (BenchmarkHarness).
+*/
+struct BenchmarkResult {
+    string phase;
+    string dataset;
+    size_t batchSize;
+    size_t items;
+    double seconds;
+    double p50;
+    double p90;
+    double p99;
+    double allocationsPerItem;
+};
+
+/**
+ * @brief Clase BenchmarkHarness que repite una fase hasta acumular un tiempo mínimo y registra, por repetición, la 
+ * latencia y las reservas de memoria dinámica (a través de allocationCount, si se compiló con 
+ * -DPERCEPTRON_COUNT_ALLOCATIONS; si no, las reservas se informan como no medidas).
+*/
+class BenchmarkHarness {
+    public:
+        vector<BenchmarkResult> results;
+        double minSeconds;
+
+        /**
+         * @brief Constructor de la clase BenchmarkHarness.
+         * 
+         * @param aMinSeconds Parámetro de tipo número de coma flotante con el tiempo mínimo que se mide cada fase.
+        */
+        BenchmarkHarness(double aMinSeconds) {
+            minSeconds = aMinSeconds;
+        };
+
+        /**
+         * @brief Método utilizado para medir una fase. Se ejecuta una vez para calentar y luego se repite hasta 
+         * superar minSeconds (al menos 5 veces).
+         * 
+         * @param phase Nombre de la fase (import_knowledge_base, get_patterns, training, resolve...).
+         * @param dataset Nombre del conjunto de datos utilizado.
+         * @param batchSize Número de caracteres por repetición (1 si la fase no trabaja por lotes).
+         * @param itemsPerRepetition Número de elementos que procesa cada repetición.
+         * @param body Función que ejecuta una repetición de la fase.
+        */
+        template <typename Body>
+        void measure(const string &phase, const string &dataset, size_t batchSize, size_t itemsPerRepetition, Body body) {
+            body();
+
+            vector<double> samples;
+            samples.reserve(1024);
+            unsigned long long allocations = 0;
+            double total = 0;
+            while (total < minSeconds || samples.size() < 5) {
+                unsigned long long allocationsBefore = allocationCount.load();
+                auto start = std::chrono::steady_clock::now();
+                body();
+                auto end = std::chrono::steady_clock::now();
+                allocations += allocationCount.load() - allocationsBefore;
+                double seconds = std::chrono::duration<double>(end - start).count();
+                samples.push_back(seconds * 1e6);
+                total += seconds;
+            };
+
+            std::sort(samples.begin(), samples.end());
+            auto percentile = [&samples](double q) {
+                return samples[std::min(samples.size() - 1, static_cast<size_t>(q * samples.size()))];
+            };
+            size_t items = samples.size() * itemsPerRepetition;
+            double allocationsPerItem = COUNTING_ALLOCATIONS ? static_cast<double>(allocations) / items : -1;
+            results.push_back({phase, dataset, batchSize, items, total, percentile(0.5), percentile(0.9),
+                               percentile(0.99), allocationsPerItem});
+        };
+
+        /**
+         * @brief Método utilizado para escribir los resultados: una línea JSON por fase, o una tabla legible.
+         * 
+         * @param output Parámetro de tipo flujo de salida.
+         * @param json Parámetro de tipo booleano (verdadero para JSON).
+        */
+        void report(std::ostream &output, bool json) const {
+            for (const BenchmarkResult &result : results) {
+                double throughput = result.items / result.seconds;
+                if (json) {
+                    output << "{\"phase\":\"" << result.phase << "\",\"dataset\":\"" << result.dataset
+                           << "\",\"batch\":" << result.batchSize << ",\"items\":" << result.items
+                           << ",\"seconds\":" << result.seconds << ",\"items_per_second\":" << throughput
+                           << ",\"p50_us\":" << result.p50 << ",\"p90_us\":" << result.p90
+                           << ",\"p99_us\":" << result.p99 << ",\"allocs_per_item\":";
+                    if (result.allocationsPerItem >= 0) {
+                        output << result.allocationsPerItem << "}\n";
+                    } else {
+                        output << "null}\n";
+                    };
+                } else {
+                    output << result.phase << " [" << result.dataset << ", lote " << result.batchSize << "]: "
+                           << throughput << " elementos/s, p50 " << result.p50 << " us, p90 " << result.p90
+                           << " us, p99 " << result.p99 << " us, ";
+                    if (result.allocationsPerItem >= 0) {
+                        output << result.allocationsPerItem << " reservas/elemento\n";
+                    } else {
+                        output << "reservas no medidas\n";
+                    };
+                };
+            };
+        };
+};
+
+/**
+ * @brief Función que genera caracteres sintéticos a partir de unos caracteres de base: cada uno es una copia de un 
+ * caracter de base con algunos píxeles invertidos al azar.
+ * 
+ * @param glyphs Parámetro de tipo vector de caracteres de base.
+ * @param count Parámetro de tipo entero con el número de caracteres a generar.
+ * @param flips Parámetro de tipo entero con el número de píxeles que se invierten en cada copia.
+ * @param seed Parámetro de tipo entero con la semilla del generador.
+ * 
+ * @return Vector de caracteres sintéticos.
+*/
+vector<Glyph> synthesize_glyphs(const vector<Glyph> &glyphs, size_t count, int flips, unsigned int seed) {
+    vector<Glyph> result;
+    if (glyphs.empty()) {
+        return result;
+    };
+    mt19937 noise(seed);
+    result.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        Glyph glyph = glyphs[i % glyphs.size()];
+        for (int f = 0; f < flips; f++) {
+            int index = noise() % PIXELS_NUM;
+            glyph.set(index / COLUMNS_NUM, index % COLUMNS_NUM, !glyph.test(index));
+        };
+        result.push_back(glyph);
+    };
+    return result;
+};
+
+/**
+ * @brief Función que ejecuta el arnés de medición sobre las fases de carga, entrenamiento e inferencia, con los 
+ * datos incluidos en el repositorio y con un conjunto sintético escalado.
+ * 
+ * @param baseFilename Parámetro de tipo cadena de caracteres con la base de conocimiento a cargar.
+ * @param factor Parámetro de tipo entero: el conjunto sintético tiene factor veces los caracteres de input.txt.
+ * @param minSeconds Parámetro de tipo número de coma flotante con el tiempo mínimo de cada fase.
+ * @param json Parámetro de tipo booleano (verdadero para salida JSON, una línea por fase).
+*/
+void run_benchmarks(const string &baseFilename, int factor, double minSeconds, bool json) {
+    BenchmarkHarness harness(minSeconds);
+
+    // Carga
+    harness.measure("import_knowledge_base", baseFilename, 1, 1, [&]() {
+        NeuralNetwork network;
+        network.import_knowledge_base(baseFilename);
+    });
+    NeuralNetwork neuralNetwork;
+    neuralNetwork.import_knowledge_base(baseFilename);
+
+    vector<vector<int>> expectedValues = get_expected_values();
+    harness.measure("get_patterns", "patterns", 1, 1, [&]() {
+        get_patterns(expectedValues);
+    });
+
+    harness.measure("get_pattern_dataset", "patterns", 1, 1, [&]() {
+        get_pattern_dataset();
+    });
+
+    // Entrenamiento
+    vector<Pattern> patterns = get_patterns(expectedValues);
+    TrainingConfig config = {EPOCHS_NUM, BATCH_SIZE, RANDOM_STATE};
+    // Cada neurona se detiene al converger, así que se cuentan las épocas que recorrió de verdad. Todas las redes
+    // parten de los mismos pesos (semilla propia, no el generador global), así que cada repetición recorre las
+    // mismas épocas que esta; un elemento es un patrón presentado a toda la red
+    size_t neuronEpochs = 0;
+    NeuralNetwork probe(LEARNING_RATE, RANDOM_STATE);
+    for (const TrainingReport &report : probe.training(patterns, config)) {
+        neuronEpochs += report.epochs.size();
+    };
+    harness.measure("training", "patterns", config.batchSize, patterns.size() * neuronEpochs / CLASSES_NUM, [&]() {
+        NeuralNetwork network(LEARNING_RATE, RANDOM_STATE);
+        network.training(patterns, config);
+    });
+
+    // Entrenamiento con muestras aumentadas; el lote es mayor que el búfer del flujo a propósito (así se comprueba
+    // que pop no bloquea a los hilos que producen mientras espera)
+    AugmentationConfig augmentation = {1, 10, 0.15f, 0.1f, 2};
+    harness.measure("training_augmented", "patterns", 1024, 4096, [&]() {
+        NeuralNetwork network;
+        AugmentationStream<Pattern> stream(patterns, augmentation, 4096, 256, 2, RANDOM_STATE);
+        network.training_stream(stream, 1024);
+    });
+
+    // Inferencia
+    vector<Glyph> shipped = read_glyphs("input.txt");
+
+    // Secuencia con ruido: 100 copias seguidas de cada caracter con 2 píxeles invertidos al azar
+    vector<Glyph> jitter;
+    if (!shipped.empty()) {
+        for (size_t g = 0; g < shipped.size() * factor; g++) {
+            jitter.push_back(synthesize_glyphs({shipped[(g / 100) % shipped.size()]}, 1, 2, g)[0]);
+        };
+        IncrementalScorer scorer(neuralNetwork);
+        long matches = 0;
+        harness.measure("resolve_incremental", "jitter", 1, jitter.size(), [&]() {
+            scorer.reset();
+            for (const Glyph &glyph : jitter) {
+                matches += scorer.resolve(glyph);
+            };
+        });
+        harness.measure("resolve", "jitter", 1, jitter.size(), [&]() {
+            for (const Glyph &glyph : jitter) {
+                matches += neuralNetwork.resolve(glyph);
+            };
+        });
+        volatile long sink = matches;
+        (void) sink;
+    };
+    vector<Glyph> synthetic = synthesize_glyphs(shipped, shipped.size() * factor, 3, RANDOM_STATE);
+    vector<pair<string, const vector<Glyph> *>> datasets = {{"input", &shipped}, {"sintetico", &synthetic}};
+    FusedNetwork fusedNetwork(neuralNetwork);
+    for (const pair<string, const vector<Glyph> *> &dataset : datasets) {
+        const vector<Glyph> &glyphs = *dataset.second;
+        if (glyphs.empty()) {
+            continue;
+        };
+        long checksum = 0;
+        NeuralNetwork::Scores output;
+        harness.measure("resolve", dataset.first, 1, glyphs.size(), [&]() {
+            for (const Glyph &glyph : glyphs) {
+                checksum += neuralNetwork.resolve(glyph, output);
+            };
+        });
+        // La primera repetición (de calentamiento) llena la tabla; las demás miden los aciertos
+        RecognitionCache cache(neuralNetwork);
+        harness.measure("resolve_cached", dataset.first, 1, glyphs.size(), [&]() {
+            for (const Glyph &glyph : glyphs) {
+                checksum += cache.resolve(glyph, output);
+            };
+        });
+
+        LayeredNetwork layered(16, RANDOM_STATE);
+        vector<float> layeredScores(glyphs.size() * LayeredNetwork::CLASSES);
+        vector<int> layeredAnswers(glyphs.size());
+        harness.measure("resolve_mlp16", dataset.first, glyphs.size(), glyphs.size(), [&]() {
+            layered.resolve_batch(glyphs.data(), glyphs.size(), layeredScores.data(), layeredAnswers.data());
+            checksum += layeredAnswers[0];
+        });
+
+        QuantizedNetwork8 quantized8(neuralNetwork);
+        QuantizedNetwork16 quantized16(neuralNetwork);
+        harness.measure("resolve_int8", dataset.first, 1, glyphs.size(), [&]() {
+            for (const Glyph &glyph : glyphs) {
+                checksum += quantized8.resolve(glyph);
+            };
+        });
+        harness.measure("resolve_int16", dataset.first, 1, glyphs.size(), [&]() {
+            for (const Glyph &glyph : glyphs) {
+                checksum += quantized16.resolve(glyph);
+            };
+        });
+
+        for (size_t batchSize : {1, 16, 256, 4096}) {
+            if (batchSize > glyphs.size()) {
+                break;
+            };
+            vector<float> scores(batchSize * FusedNetwork::CLASSES);
+            vector<int> answers(batchSize);
+            size_t offset = 0;
+            harness.measure("resolve_batch", dataset.first, batchSize, batchSize, [&]() {
+                if (offset + batchSize > glyphs.size()) {
+                    offset = 0;
+                };
+                fusedNetwork.resolve_batch(glyphs.data() + offset, batchSize, scores.data(), answers.data());
+                checksum += answers[0];
+                offset += batchSize;
+            });
+            offset = 0;
+            harness.measure("resolve_batch_cached", dataset.first, batchSize, batchSize, [&]() {
+                if (offset + batchSize > glyphs.size()) {
+                    offset = 0;
+                };
+                cache.resolve_batch(glyphs.data() + offset, batchSize, scores.data(), answers.data());
+                checksum += answers[0];
+                offset += batchSize;
+            });
+        };
+        // Evita que el compilador descarte las inferencias medidas
+        volatile long sink = checksum;
+        (void) sink;
+    };
+
+    harness.report(cout, json);
+};
+
+/**
+ * @brief Función que busca caracteres en un texto con formato libre (por ejemplo test/test.txt o 
+ * test/asking_examples.txt): acepta filas "0 1 0 ..." y filas de código "{0, 1, 0, ...},", e ignora comentarios, 
+ * registros y demás líneas. Un caracter son ROWS_NUM filas seguidas de COLUMNS_NUM dígitos; cualquier otra línea 
+ * descarta las filas acumuladas. Una línea "// LETRA X" (X = A, E, I, O, U) asigna esa vocal como clase de los 
+ * caracteres que la siguen; antes de la primera, la clase es -1.
+ * 
+ * @param begin Puntero al primer caracter del texto.
+ * @param end Puntero a la posición siguiente al último caracter del texto.
+ * 
+ * @return Conjunto de datos con los caracteres, en el orden en que aparecen en el texto, y su clase.
+*/
+PatternDataset scan_labeled_glyphs(const char *begin, const char *end) {
+    PatternDataset dataset;
+    Glyph glyph;
+    int row = 0;
+    int label = -1;
+    const string vowels = "AEIOU";
+    const char header[] = "LETRA ";
+    const char *line = begin;
+    while (line < end) {
+        const char *lineEnd = static_cast<const char *>(std::memchr(line, '\n', end - line));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        };
+        const char *found = std::search(line, lineEnd, header, header + 6);
+        if (lineEnd - found > 6) {
+            size_t vowel = vowels.find(found[6]);
+            label = vowel != string::npos ? static_cast<int>(vowel) : -1;
+        };
+
+        int column = 0;
+        bool valid = true;
+        for (const char *character = line; character < lineEnd; character++) {
+            if (*character == '0' || *character == '1') {
+                if (column < COLUMNS_NUM) {
+                    glyph.set(row, column, *character == '1');
+                };
+                column++;
+            } else if (*character != ' ' && *character != ',' && *character != '{' && *character != '}' &&
+                       *character != '\t' && *character != '\r') {
+                valid = false;
+            };
+        };
+        line = lineEnd + 1;
+        if (!valid || column != COLUMNS_NUM) {
+            row = 0;
+            glyph.clear();
+            continue;
+        };
+        if (++row == ROWS_NUM) {
+            dataset.add(glyph, label);
+            glyph.clear();
+            row = 0;
+        };
+    };
+    return dataset;
+};
+
+/**
+ * @brief Función que busca caracteres en un archivo con formato libre (ver la versión que recibe el texto).
+ * 
+ * @param filename Parámetro de tipo cadena de caracteres que representa el nombre del archivo.
+ * 
+ * @return Conjunto de datos con los caracteres, en el orden en que aparecen en el archivo, y su clase.
+*/
+PatternDataset scan_labeled_glyphs(const string &filename) {
+    METRIC_TIMER(TIMER_READ_GLYPHS);
+    MappedFile content;
+    if (!content.open(filename)) {
+        throw std::runtime_error("No se pudo abrir el archivo de caracteres " + filename + ".");
+    };
+    return scan_labeled_glyphs(content.data, content.data + content.size);
+};
+
+/**
+ * @brief Función que busca caracteres en un archivo con formato libre (ver scan_labeled_glyphs).
+ * 
+ * @param filename Parámetro de tipo cadena de caracteres que representa el nombre del archivo.
+ * 
+ * @return Vector de caracteres (Glyph) en el orden en que aparecen en el archivo.
+*/
+vector<Glyph> scan_glyphs(const string &filename) {
+    return scan_labeled_glyphs(filename).glyphs;
+};
+
+// INGESTA DE IMÁGENES
+
+/**
+ * @brief Configuración de la ingesta de imágenes: umbral de binarización (gris máximo que se considera tinta, -1 = 
+ * automático por el método de Otsu), longitud mínima de trazo para encender una celda del caracter (en lados de 
+ * celda) y mínimo de píxeles de tinta de una caja (las cajas con menos se descartan como ruido).
+*/
+struct IngestionConfig {
+    int threshold;
+    float coverage;
+    int minInk;
+};
+
+/**
+ * @brief Clase GrayImage que guarda una imagen en escala de grises de 8 bits (0 = negro, 255 = blanco), fila por 
+ * fila. Lee los formatos PGM (P2, P5) y PPM (P3, P6) con 8 o 16 bits por muestra; el color se convierte a 
+ * luminancia.
+*/
+class GrayImage {
+    public:
+        int width;
+        int height;
+        vector<uint8_t> pixels;
+
+        /**
+         * @brief Constructor de la clase GrayImage. Lee la imagen del archivo dado.
+         * 
+         * @param filename Parámetro de tipo cadena de caracteres con el nombre del archivo (.pgm o .ppm).
+        */
+        GrayImage(const string &filename) {
+            MappedFile file;
+            if (!file.open(filename)) {
+                throw std::runtime_error("No se pudo abrir la imagen " + filename + ".");
+            };
+            decode(file.data, file.size, filename);
+        };
+
+        /**
+         * @brief Método utilizado para decodificar una imagen PGM/PPM en memoria.
+         * 
+         * @param data Puntero al contenido del archivo.
+         * @param size Tamaño del contenido en bytes.
+         * @param filename Parámetro de tipo cadena de caracteres con el nombre del archivo (para los mensajes de error).
+        */
+        void decode(const char *data, size_t size, const string &filename) {
+            if (size < 2 || data[0] != 'P' || string("2356").find(data[1]) == string::npos) {
+                throw std::runtime_error("La imagen " + filename + " no es PGM ni PPM (P2, P3, P5 o P6).");
+            };
+            bool binary = data[1] == '5' || data[1] == '6';
+            int channels = (data[1] == '3' || data[1] == '6') ? 3 : 1;
+            size_t position = 2;
+
+            // Números de la cabecera (y de las muestras en P2/P3), separados por espacios y comentarios '#'
+            auto next_number = [&]() {
+                while (position < size && (std::isspace(static_cast<unsigned char>(data[position])) || data[position] == '#')) {
+                    if (data[position] == '#') {
+                        while (position < size && data[position] != '\n') {
+                            position++;
+                        };
+                    } else {
+                        position++;
+                    };
+                };
+                if (position >= size || !std::isdigit(static_cast<unsigned char>(data[position]))) {
+                    throw std::runtime_error("La imagen " + filename + " está incompleta o mal formada.");
+                };
+                long value = 0;
+                while (position < size && std::isdigit(static_cast<unsigned char>(data[position])) && value < 1 << 24) {
+                    value = value * 10 + (data[position++] - '0');
+                };
+                return static_cast<int>(value);
+            };
+
+            width = next_number();
+            height = next_number();
+            int maxValue = next_number();
+            if (width <= 0 || height <= 0 || width >= 1 << 15 || height >= 1 << 15 || maxValue <= 0 || maxValue > 65535) {
+                throw std::runtime_error("La imagen " + filename + " tiene una cabecera no válida.");
+            };
+            // En los formatos binarios, un único espacio separa la cabecera de las muestras
+            position += binary;
+            int bytes = maxValue > 255 ? 2 : 1;
+            size_t count = static_cast<size_t>(width) * height;
+            if (binary && (position > size || size - position < count * channels * bytes)) {
+                throw std::runtime_error("La imagen " + filename + " está incompleta o mal formada.");
+            };
+
+            pixels.resize(count);
+            if (binary && channels == 1 && maxValue == 255) {
+                std::memcpy(pixels.data(), data + position, count);
+                return;
+            };
+            auto next_sample = [&]() {
+                if (!binary) {
+                    return next_number();
+                };
+                int value = static_cast<unsigned char>(data[position++]);
+                if (bytes == 2) {
+                    value = (value << 8) | static_cast<unsigned char>(data[position++]);
+                };
+                return value;
+            };
+            for (size_t i = 0; i < count; i++) {
+                int value = next_sample();
+                if (channels == 3) {
+                    int green = next_sample();
+                    int blue = next_sample();
+                    value = (77 * value + 150 * green + 29 * blue) >> 8;
+                };
+                pixels[i] = static_cast<uint8_t>(std::min(value, maxValue) * 255 / maxValue);
+            };
+        };
+};
+
+/**
+ * @brief Función que calcula el umbral de binarización de una imagen por el método de Otsu: el gris que maximiza 
+ * la varianza entre las dos clases (tinta y fondo) del histograma.
+ * 
+ * @param image Parámetro de tipo GrayImage.
+ * 
+ * @return Número entero entre 0 y 255 (gris máximo de la clase oscura).
+*/
+int otsu_threshold(const GrayImage &image) {
+    std::array<size_t, 256> histogram = {};
+    for (uint8_t pixel : image.pixels) {
+        histogram[pixel]++;
+    };
+    double total = image.pixels.size();
+    double sum = 0;
+    for (int value = 0; value < 256; value++) {
+        sum += value * static_cast<double>(histogram[value]);
+    };
+
+    double darkCount = 0;
+    double darkSum = 0;
+    double bestVariance = -1;
+    int threshold = 127;
+    for (int value = 0; value < 255; value++) {
+        darkCount += histogram[value];
+        darkSum += value * static_cast<double>(histogram[value]);
+        if (darkCount == 0 || darkCount == total) {
+            continue;
+        };
+        double darkMean = darkSum / darkCount;
+        double lightMean = (sum - darkSum) / (total - darkCount);
+        double variance = darkCount * (total - darkCount) * (darkMean - lightMean) * (darkMean - lightMean);
+        if (variance > bestVariance) {
+            bestVariance = variance;
+            threshold = value;
+        };
+    };
+    return threshold;
+};
+
+/**
+ * @brief Función que binariza una imagen: tinta = gris menor o igual que el umbral. Si más de la mitad de la imagen 
+ * resulta tinta, se entiende que es texto claro sobre fondo oscuro y se invierte.
+ * 
+ * @param image Parámetro de tipo GrayImage.
+ * @param threshold Parámetro de tipo entero con el gris máximo de la tinta (-1 = método de Otsu).
+ * 
+ * @return Vector de bytes (1 = tinta), fila por fila.
+*/
+vector<uint8_t> binarize_image(const GrayImage &image, int threshold) {
+    if (threshold < 0) {
+        threshold = otsu_threshold(image);
+    };
+    // Pasadas contiguas sobre bytes, que el compilador vectoriza
+    vector<uint8_t> ink(image.pixels.size());
+    size_t inkCount = 0;
+    for (size_t i = 0; i < ink.size(); i++) {
+        ink[i] = image.pixels[i] <= threshold;
+        inkCount += ink[i];
+    };
+    if (inkCount * 2 > ink.size()) {
+        for (uint8_t &pixel : ink) {
+            pixel ^= 1;
+        };
+    };
+    return ink;
+};
+
+/**
+ * @brief Función que adelgaza los trazos de una imagen binaria hasta un píxel de ancho (algoritmo de Zhang-Suen) 
+ * sin romper su conectividad. Los patrones de entrenamiento se dibujan con trazos de una celda, así que el grosor 
+ * del trazo de la foto no debe llegar al caracter.
+ * 
+ * @param ink Parámetro de tipo vector de bytes (1 = tinta) con la imagen, fila por fila; se modifica.
+ * @param width Parámetro de tipo entero con el ancho de la imagen.
+ * @param height Parámetro de tipo entero con el alto de la imagen.
+*/
+void thin_strokes(vector<uint8_t> &ink, int width, int height) {
+    // Copia con un borde sin tinta, para consultar los 8 vecinos sin comprobar los límites de la imagen
+    ptrdiff_t stride = width + 2;
+    vector<uint8_t> padded(stride * (height + 2), 0);
+    vector<ptrdiff_t> candidates;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (ink[static_cast<size_t>(y) * width + x]) {
+                padded[(y + 1) * stride + x + 1] = 1;
+                candidates.push_back((y + 1) * stride + x + 1);
+            };
+        };
+    };
+    // Vecinos en orden: norte, noreste, este, sureste, sur, suroeste, oeste, noroeste
+    const ptrdiff_t offsets[8] = {-stride, -stride + 1, 1, stride + 1, stride, stride - 1, -1, -stride - 1};
+
+    // Para cada combinación de vecinos (bit k = vecino k) y subiteración, si el píxel se puede borrar
+    std::array<std::array<bool, 256>, 2> removable;
+    for (int mask = 0; mask < 256; mask++) {
+        int p[8];
+        int neighbours = 0;
+        int transitions = 0;
+        for (int k = 0; k < 8; k++) {
+            p[k] = (mask >> k) & 1;
+            neighbours += p[k];
+        };
+        for (int k = 0; k < 8; k++) {
+            transitions += !p[k] && p[(k + 1) % 8];
+        };
+        bool candidate = neighbours >= 2 && neighbours <= 6 && transitions == 1;
+        removable[0][mask] = candidate && !(p[0] && p[2] && p[4]) && !(p[2] && p[4] && p[6]);
+        removable[1][mask] = candidate && !(p[0] && p[2] && p[6]) && !(p[0] && p[4] && p[6]);
+    };
+
+    vector<ptrdiff_t> removed;
+    vector<ptrdiff_t> kept;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int step = 0; step < 2; step++) {
+            removed.clear();
+            kept.clear();
+            for (ptrdiff_t i : candidates) {
+                const uint8_t *pixel = padded.data() + i;
+                int mask = 0;
+                for (int k = 0; k < 8; k++) {
+                    mask |= pixel[offsets[k]] << k;
+                };
+                if (removable[step][mask]) {
+                    removed.push_back(i);
+                } else {
+                    kept.push_back(i);
+                };
+            };
+            // Los píxeles de una subiteración se borran juntos, después de examinarlos todos
+            for (ptrdiff_t i : removed) {
+                padded[i] = 0;
+            };
+            changed = changed || !removed.empty();
+            candidates.swap(kept);
+        };
+    };
+
+    for (int y = 0; y < height; y++) {
+        std::memcpy(ink.data() + static_cast<size_t>(y) * width, padded.data() + (y + 1) * stride + 1, width);
+    };
+};
+
+/**
+ * @brief Función que indica si el píxel (x, y) de una imagen binaria no tiene ningún vecino con tinta.
+*/
+bool is_isolated(const vector<uint8_t> &ink, int width, int height, int x, int y) {
+    for (int ny = std::max(0, y - 1); ny <= std::min(height - 1, y + 1); ny++) {
+        for (int nx = std::max(0, x - 1); nx <= std::min(width - 1, x + 1); nx++) {
+            if ((nx != x || ny != y) && ink[static_cast<size_t>(ny) * width + nx]) {
+                return false;
+            };
+        };
+    };
+    return true;
+};
+
+/**
+ * @brief Función que obtiene el esqueleto de los trazos de una imagen binaria (ver thin_strokes), con un peso por 
+ * píxel: 1 para los píxeles de un trazo y, para un punto aislado (por ejemplo, el punto de la i, que el 
+ * adelgazamiento reduce a un píxel), el diámetro de la mancha original, de modo que cuente como un trazo de esa 
+ * longitud.
+ * 
+ * @param ink Parámetro de tipo vector de bytes (1 = tinta) con la imagen binarizada.
+ * @param width Parámetro de tipo entero con el ancho de la imagen.
+ * @param height Parámetro de tipo entero con el alto de la imagen.
+ * 
+ * @return Vector de pesos, fila por fila (0 = sin tinta).
+*/
+vector<uint32_t> stroke_skeleton(const vector<uint8_t> &ink, int width, int height) {
+    vector<uint8_t> thin = ink;
+    thin_strokes(thin, width, height);
+    vector<uint32_t> weights(thin.begin(), thin.end());
+
+    vector<uint8_t> visited(ink.size(), 0);
+    vector<size_t> pending;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            size_t i = static_cast<size_t>(y) * width + x;
+            if (!thin[i] || !is_isolated(thin, width, height, x, y)) {
+                continue;
+            };
+
+            // Área de la mancha original (componente de 8 vecinos de la tinta) que se redujo a este píxel
+            size_t area = 0;
+            pending.assign(1, i);
+            visited[i] = 1;
+            while (!pending.empty()) {
+                size_t current = pending.back();
+                pending.pop_back();
+                area++;
+                int cx = current % width;
+                int cy = current / width;
+                for (int dy = -1; dy <= 1; dy++) {
+                    for (int dx = -1; dx <= 1; dx++) {
+                        int nx = cx + dx;
+                        int ny = cy + dy;
+                        size_t next = static_cast<size_t>(ny) * width + nx;
+                        if (nx >= 0 && ny >= 0 && nx < width && ny < height && ink[next] && !visited[next]) {
+                            visited[next] = 1;
+                            pending.push_back(next);
+                        };
+                    };
+                };
+            };
+            weights[i] = std::max<uint32_t>(1, static_cast<uint32_t>(std::lround(2 * std::sqrt(area / 3.14159265))));
+        };
+    };
+    return weights;
+};
+
+/**
+ * @brief Caja de un caracter dentro de una imagen: columnas [left, right) y filas [top, bottom), en píxeles.
+*/
+struct GlyphBox {
+    int left;
+    int top;
+    int right;
+    int bottom;
+};
+
+/**
+ * @brief Clase InkImage que guarda la tinta de una imagen (binarizada o su esqueleto ponderado) como tabla de áreas 
+ * acumuladas (la entrada (x, y) es la tinta del rectángulo [0, x) x [0, y)). Así la tinta de cualquier 
+ * rectángulo, con bordes enteros o fraccionarios, cuesta cuatro consultas, sin importar su tamaño.
+*/
+class InkImage {
+    public:
+        int width;
+        int height;
+        vector<uint32_t> table;
+
+        /**
+         * @brief Constructor de la clase InkImage. Construye la tabla a partir de la tinta de cada píxel.
+         * 
+         * @param values Parámetro de tipo vector con la tinta de cada píxel (0 = sin tinta), fila por fila.
+         * @param aWidth Parámetro de tipo entero con el ancho de la imagen.
+         * @param aHeight Parámetro de tipo entero con el alto de la imagen.
+        */
+        template <typename Value>
+        InkImage(const vector<Value> &values, int aWidth, int aHeight) {
+            width = aWidth;
+            height = aHeight;
+            // Suma por filas y luego una pasada contigua con la fila anterior, que el compilador vectoriza
+            size_t stride = width + 1;
+            table.assign(stride * (height + 1), 0);
+            for (int y = 0; y < height; y++) {
+                uint32_t *row = table.data() + (y + 1) * stride;
+                const uint32_t *above = row - stride;
+                const Value *source = values.data() + static_cast<size_t>(y) * width;
+                uint32_t sum = 0;
+                for (int x = 0; x < width; x++) {
+                    sum += source[x];
+                    row[x + 1] = sum;
+                };
+                for (int x = 1; x <= width; x++) {
+                    row[x] += above[x];
+                };
+            };
+        };
+
+        /**
+         * @brief Método utilizado para obtener la tinta del rectángulo [left, right) x [top, bottom) (bordes enteros).
+        */
+        uint32_t ink(int left, int top, int right, int bottom) const {
+            size_t stride = width + 1;
+            return table[bottom * stride + right] - table[top * stride + right] - table[bottom * stride + left] +
+                   table[top * stride + left];
+        };
+
+        /**
+         * @brief Método utilizado para obtener la tinta del rectángulo [0, x) x [0, y) con x e y fraccionarios. Dentro 
+         * de cada píxel la tinta acumulada es bilineal, así que interpolar la tabla da el área exacta.
+        */
+        double cumulative(double x, double y) const {
+            int column = std::min(static_cast<int>(x), width - 1);
+            int row = std::min(static_cast<int>(y), height - 1);
+            double fx = x - column;
+            double fy = y - row;
+            size_t stride = width + 1;
+            const uint32_t *top = table.data() + row * stride + column;
+            const uint32_t *bottom = top + stride;
+            return (1 - fy) * ((1 - fx) * top[0] + fx * top[1]) + fy * ((1 - fx) * bottom[0] + fx * bottom[1]);
+        };
+
+        /**
+         * @brief Método utilizado para obtener la tinta del rectángulo [left, right) x [top, bottom) (bordes 
+         * fraccionarios dentro de la imagen).
+        */
+        double ink(double left, double top, double right, double bottom) const {
+            return cumulative(right, bottom) - cumulative(left, bottom) - cumulative(right, top) + cumulative(left, top);
+        };
+
+        /**
+         * @brief Método utilizado para separar los caracteres de la imagen, en orden de lectura. Primero se buscan 
+         * las líneas de texto (franjas de filas con tinta; dos franjas separadas por menos de la mitad de la más alta 
+         * se unen, por ejemplo el punto de la i) y luego, dentro de cada línea, los caracteres (franjas de columnas 
+         * con tinta, unidas si las separa menos de una décima de la altura de la línea). Cada caja se ajusta a su 
+         * tinta y las que tienen menos de minInk píxeles se descartan. Se usa con la tinta completa, no con el 
+         * esqueleto, para que el adelgazamiento no separe el punto de la i de su trazo.
+         * 
+         * @param minInk Parámetro de tipo entero con el mínimo de píxeles de tinta de un caracter.
+         * 
+         * @return Vector de GlyphBox.
+        */
+        vector<GlyphBox> segment(int minInk) const {
+            vector<GlyphBox> boxes;
+            auto runs = [](int count, int maxGap, const std::function<bool(int)> &hasInk) {
+                vector<pair<int, int>> found;
+                for (int i = 0; i < count; i++) {
+                    if (!hasInk(i)) {
+                        continue;
+                    };
+                    int start = i;
+                    while (i < count && hasInk(i)) {
+                        i++;
+                    };
+                    if (!found.empty() && start - found.back().second <= maxGap) {
+                        found.back().second = i;
+                    } else {
+                        found.emplace_back(start, i);
+                    };
+                };
+                return found;
+            };
+
+            vector<pair<int, int>> lines = runs(height, 0, [this](int y) { return ink(0, y, width, y + 1) > 0; });
+            vector<pair<int, int>> merged;
+            for (const pair<int, int> &line : lines) {
+                if (!merged.empty()) {
+                    int gap = line.first - merged.back().second;
+                    int tallest = std::max(line.second - line.first, merged.back().second - merged.back().first);
+                    if (gap * 2 < tallest) {
+                        merged.back().second = line.second;
+                        continue;
+                    };
+                };
+                merged.push_back(line);
+            };
+
+            for (const pair<int, int> &line : merged) {
+                int top = line.first;
+                int bottom = line.second;
+                vector<pair<int, int>> columns = runs(width, (bottom - top) / 10, [&](int x) {
+                    return ink(x, top, x + 1, bottom) > 0;
+                });
+                for (const pair<int, int> &column : columns) {
+                    GlyphBox box = {column.first, top, column.second, bottom};
+                    if (static_cast<int>(ink(box.left, box.top, box.right, box.bottom)) < minInk) {
+                        continue;
+                    };
+                    while (ink(box.left, box.top, box.right, box.top + 1) == 0) {
+                        box.top++;
+                    };
+                    while (ink(box.left, box.bottom - 1, box.right, box.bottom) == 0) {
+                        box.bottom--;
+                    };
+                    boxes.push_back(box);
+                };
+            };
+            return boxes;
+        };
+
+        /**
+         * @brief Método utilizado para reducir una caja a un caracter de Rows x Columns por remuestreo de área: la 
+         * caja se escala sin deformarla hasta ocupar la zona donde se escriben las vocales de los patrones 
+         * (5/8 de las filas y 4/5 de las columnas, centrada) y se suma la tinta que cae en cada celda. Se usa con 
+         * el esqueleto (ver stroke_skeleton): como los trazos tienen un píxel de ancho, esa tinta es la longitud del 
+         * trazo dentro de la celda, y la celda se enciende si llega a coverage veces su lado.
+         * 
+         * @param box Parámetro de tipo GlyphBox con la caja del caracter.
+         * @param coverage Parámetro de tipo número de coma flotante con la longitud mínima de trazo de una celda, en 
+         * lados de celda.
+         * 
+         * @return Caracter (GlyphType) resultante.
+        */
+        template <typename GlyphType>
+        GlyphType resample(const GlyphBox &box, float coverage) const {
+            const int Rows = GlyphType::ROWS;
+            const int Columns = GlyphType::COLUMNS;
+            double boxWidth = box.right - box.left;
+            double boxHeight = box.bottom - box.top;
+            // Celdas por píxel y posición (en celdas) de la caja escalada dentro del caracter
+            double scale = std::min(Rows * 5 / 8.0 / boxHeight, Columns * 4 / 5.0 / boxWidth);
+            double top = (Rows - boxHeight * scale) / 2;
+            double left = (Columns - boxWidth * scale) / 2;
+            double cellSide = 1 / scale;
+
+            GlyphType glyph;
+            for (int r = 0; r < Rows; r++) {
+                double y0 = std::max<double>(box.top, box.top + (r - top) / scale);
+                double y1 = std::min<double>(box.bottom, box.top + (r + 1 - top) / scale);
+                if (y1 <= y0) {
+                    continue;
+                };
+                for (int c = 0; c < Columns; c++) {
+                    double x0 = std::max<double>(box.left, box.left + (c - left) / scale);
+                    double x1 = std::min<double>(box.right, box.left + (c + 1 - left) / scale);
+                    if (x1 > x0 && ink(x0, y0, x1, y1) >= coverage * cellSide) {
+                        glyph.set(r, c, true);
+                    };
+                };
+            };
+            return glyph;
+        };
+};
+
+/**
+ * @brief Función que convierte una imagen en los caracteres que contiene, en orden de lectura.
+ * 
+ * @param image Parámetro de tipo GrayImage.
+ * @param config Parámetro de tipo IngestionConfig con el umbral, la cobertura y el mínimo de tinta.
+ * @param glyphs Parámetro de tipo vector de caracteres al que se añaden los caracteres encontrados.
+ * 
+ * @return Número de caracteres añadidos.
+*/
+template <typename GlyphType>
+size_t extract_glyphs(const GrayImage &image, const IngestionConfig &config, vector<GlyphType> &glyphs) {
+    vector<uint8_t> ink = binarize_image(image, config.threshold);
+    InkImage strokes(ink, image.width, image.height);
+    InkImage skeleton(stroke_skeleton(ink, image.width, image.height), image.width, image.height);
+    vector<GlyphBox> boxes = strokes.segment(config.minInk);
+    for (const GlyphBox &box : boxes) {
+        glyphs.push_back(skeleton.resample<GlyphType>(box, config.coverage));
+    };
+    return boxes.size();
+};
+
+/**
+ * @brief Función que compara las respuestas de una red cuantizada con las de la red en coma flotante sobre los 
+ * caracteres de un archivo, e informa cuántas coinciden y el mayor error en la entrada neta.
+ * 
+ * @param network Parámetro de tipo NeuralNetwork (referencia en coma flotante).
+ * @param quantizedNetwork Parámetro de tipo red cuantizada construida a partir de network.
+ * @param glyphs Parámetro de tipo vector de caracteres a comparar.
+ * @param name Parámetro de tipo cadena de caracteres con el nombre de la red cuantizada.
+ * 
+ * @return Verdadero si hay caracteres y todas las respuestas coinciden (un archivo sin caracteres no valida nada).
+*/
+template <typename QuantizedType>
+bool validate_quantized(const NeuralNetwork &network, const QuantizedType &quantizedNetwork, const vector<Glyph> &glyphs,
+                        const string &name) {
+    size_t matches = 0;
+    float maxError = 0;
+    int32_t sums[QuantizedType::CLASSES];
+    for (const Glyph &glyph : glyphs) {
+        // Sin resolve_batch: la comparación no son caracteres servidos y no debe contarse en las métricas
+        quantizedNetwork.net_inputs(glyph, sums);
+        matches += quantizedNetwork.competition(sums) == network.resolve(glyph);
+        for (int c = 0; c < QuantizedType::CLASSES; c++) {
+            float logit = sums[c] * quantizedNetwork.scale;
+            maxError = std::max(maxError, std::fabs(logit - network.perceptrons[c].net_input(glyph)));
+        };
+    };
+    cout << name << ": " << matches << "/" << glyphs.size() << " respuestas iguales, error máximo de entrada neta "
+         << maxError << " (escala " << quantizedNetwork.scale << ")\n";
+    return !glyphs.empty() && matches == glyphs.size();
+};
+
+/**
+ * @brief Clase BasicEvaluationReport que acumula el resultado de evaluar una red con un conjunto de datos 
+ * etiquetado: una matriz de confusión por cada umbral de MIN_OUTPUT probado. Las filas son la clase real y las 
+ * columnas la respuesta de la red; la última columna (Classes) cuenta los caracteres sin respuesta (rechazos).
+*/
+template <int Classes>
+class BasicEvaluationReport {
+    public:
+        using Matrix = std::array<std::array<size_t, Classes + 1>, Classes>;
+
+        vector<float> thresholds;
+        vector<Matrix> confusion;
+        size_t unlabeled;
+
+        /**
+         * @brief Constructor de la clase BasicEvaluationReport. Todas las matrices empiezan en cero.
+         * 
+         * @param aThresholds Parámetro de tipo vector de números de coma flotante con los umbrales a probar.
+        */
+        BasicEvaluationReport(const vector<float> &aThresholds) {
+            thresholds = aThresholds;
+            confusion.assign(thresholds.size(), Matrix{});
+            unlabeled = 0;
+        };
+
+        /**
+         * @brief Método utilizado para sumar otro resultado parcial con los mismos umbrales.
+        */
+        void merge(const BasicEvaluationReport &other) {
+            for (size_t t = 0; t < confusion.size(); t++) {
+                for (int real = 0; real < Classes; real++) {
+                    for (int answer = 0; answer <= Classes; answer++) {
+                        confusion[t][real][answer] += other.confusion[t][real][answer];
+                    };
+                };
+            };
+            unlabeled += other.unlabeled;
+        };
+
+        size_t total(size_t t) const {
+            size_t count = 0;
+            for (const auto &row : confusion[t]) {
+                count += std::accumulate(row.begin(), row.end(), size_t(0));
+            };
+            return count;
+        };
+
+        size_t hits(size_t t) const {
+            size_t count = 0;
+            for (int c = 0; c < Classes; c++) {
+                count += confusion[t][c][c];
+            };
+            return count;
+        };
+
+        size_t rejected(size_t t) const {
+            size_t count = 0;
+            for (const auto &row : confusion[t]) {
+                count += row[Classes];
+            };
+            return count;
+        };
+
+        /**
+         * @brief Método utilizado para obtener la posición del umbral con más aciertos.
+         * 
+         * @param preferred Parámetro de tipo entero con la posición del umbral que se elige si empata (por ejemplo, 
+         * la de MIN_OUTPUT); entre los demás empates se elige el menor.
+        */
+        size_t best_threshold(size_t preferred = 0) const {
+            size_t best = std::min(preferred, thresholds.size() - 1);
+            for (size_t t = 0; t < thresholds.size(); t++) {
+                if (hits(t) > hits(best)) {
+                    best = t;
+                };
+            };
+            return best;
+        };
+
+        /**
+         * @brief Método utilizado para escribir la matriz de confusión de un umbral y, debajo, el barrido de 
+         * umbrales (aciertos, errores y rechazos de cada uno).
+         * 
+         * @param output Parámetro de tipo flujo de salida.
+         * @param t Parámetro de tipo entero con la posición del umbral cuya matriz se muestra.
+        */
+        void print(std::ostream &output, size_t t) const {
+            const char *vowels[] = {"a", "e", "i", "o", "u"};
+            auto name = [&vowels](int c) {
+                return (Classes == 5 && c < 5) ? string(vowels[c]) : to_string(c);
+            };
+            char line[160];
+            std::snprintf(line, sizeof(line), "matriz de confusión (umbral %.2f, filas = clase real):\n%6s", thresholds[t], "");
+            output << line;
+            for (int answer = 0; answer <= Classes; answer++) {
+                std::snprintf(line, sizeof(line), "%6s", answer < Classes ? name(answer).c_str() : "-");
+                output << line;
+            };
+            output << "\n";
+            for (int real = 0; real < Classes; real++) {
+                std::snprintf(line, sizeof(line), "%6s", name(real).c_str());
+                output << line;
+                for (int answer = 0; answer <= Classes; answer++) {
+                    std::snprintf(line, sizeof(line), "%6zu", confusion[t][real][answer]);
+                    output << line;
+                };
+                output << "\n";
+            };
+
+            output << "umbral  aciertos  errores  rechazos  precisión\n";
+            for (size_t s = 0; s < thresholds.size(); s++) {
+                size_t count = total(s);
+                size_t hitsCount = hits(s);
+                size_t rejectedCount = rejected(s);
+                std::snprintf(line, sizeof(line), "%6.2f  %8zu  %7zu  %8zu  %8.2f%%%s\n", thresholds[s], hitsCount,
+                              count - hitsCount - rejectedCount, rejectedCount,
+                              count > 0 ? 100.0 * hitsCount / count : 0.0, s == t ? "  <" : "");
+                output << line;
+            };
+            if (unlabeled > 0) {
+                output << unlabeled << " caracteres sin clase no se evaluaron\n";
+            };
+        };
+};
+
+using EvaluationReport = BasicEvaluationReport<CLASSES_NUM>;
+
+/**
+ * @brief Función que acumula en un informe la evaluación de los caracteres [begin, end) de un conjunto de datos, en 
+ * el hilo que la llama. Las salidas de las neuronas de cada caracter se calculan una sola vez y se reutilizan para 
+ * todos los umbrales: cada umbral solo repite la competencia.
+ * 
+ * @param network Parámetro de tipo red neuronal (de solo lectura durante la evaluación).
+ * @param dataset Parámetro de tipo conjunto de datos con size(), glyph(i) y label(i) (-1 = sin clase).
+ * @param thresholds Parámetro de tipo vector de números de coma flotante con los umbrales a probar.
+ * @param begin Parámetro de tipo entero con el primer caracter.
+ * @param end Parámetro de tipo entero con la posición siguiente al último caracter.
+ * @param report Parámetro de tipo BasicEvaluationReport donde se acumulan las matrices.
+*/
+template <typename NetworkType, typename DatasetType>
+void evaluate_range(const NetworkType &network, const DatasetType &dataset, const vector<float> &thresholds,
+                    size_t begin, size_t end, BasicEvaluationReport<NetworkType::CLASSES> &report) {
+    typename NetworkType::Scores scores;
+    for (size_t i = begin; i < end; i++) {
+        int label = dataset.label(i);
+        if (label < 0 || label >= NetworkType::CLASSES) {
+            report.unlabeled++;
+            continue;
+        };
+        network.process_input(dataset.glyph(i), scores);
+        for (size_t t = 0; t < thresholds.size(); t++) {
+            int answer = network.competition(scores, thresholds[t]);
+            report.confusion[t][label][answer >= 0 ? answer : NetworkType::CLASSES]++;
+        };
+    };
+};
+
+/**
+ * @brief Función que evalúa una red con un conjunto de datos etiquetado en el hilo que la llama, sin crear hilos 
+ * (por ejemplo, desde una tarea que ya corre en un ThreadPool). Da el mismo resultado que la versión con hilos.
+ * 
+ * @param network Parámetro de tipo red neuronal (de solo lectura durante la evaluación).
+ * @param dataset Parámetro de tipo conjunto de datos con size(), glyph(i) y label(i) (-1 = sin clase).
+ * @param thresholds Parámetro de tipo vector de números de coma flotante con los umbrales a probar.
+ * 
+ * @return EvaluationReport con una matriz de confusión por umbral.
+*/
+template <typename NetworkType, typename DatasetType>
+BasicEvaluationReport<NetworkType::CLASSES> evaluate_network(const NetworkType &network, const DatasetType &dataset,
+                                                             const vector<float> &thresholds) {
+    BasicEvaluationReport<NetworkType::CLASSES> report(thresholds);
+    evaluate_range(network, dataset, thresholds, 0, dataset.size(), report);
+    return report;
+};
+
+/**
+ * @brief Función que evalúa una red con un conjunto de datos etiquetado, repartiendo los caracteres entre varios 
+ * hilos (ver evaluate_range). Cada bloque acumula sus propias matrices y al final se suman en orden, así que el 
+ * resultado no depende del número de hilos.
+ * 
+ * @param network Parámetro de tipo red neuronal (de solo lectura durante la evaluación).
+ * @param dataset Parámetro de tipo conjunto de datos con size(), glyph(i) y label(i) (-1 = sin clase).
+ * @param thresholds Parámetro de tipo vector de números de coma flotante con los umbrales a probar.
+ * @param threadsNumber Parámetro de tipo entero con el número de hilos (0 = todos los núcleos).
+ * 
+ * @return EvaluationReport con una matriz de confusión por umbral.
+*/
+template <typename NetworkType, typename DatasetType>
+BasicEvaluationReport<NetworkType::CLASSES> evaluate_network(const NetworkType &network, const DatasetType &dataset,
+                                                             const vector<float> &thresholds, int threadsNumber) {
+    using ReportType = BasicEvaluationReport<NetworkType::CLASSES>;
+    const size_t CHUNK_SIZE = 1024;
+    size_t chunksNumber = (dataset.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    vector<ReportType> partials(chunksNumber, ReportType(thresholds));
+
+    ThreadPool pool(threadsNumber);
+    pool.parallel_for(dataset.size(), CHUNK_SIZE, [&](size_t begin, size_t end) {
+        evaluate_range(network, dataset, thresholds, begin, end, partials[begin / CHUNK_SIZE]);
+    });
+
+    ReportType report(thresholds);
+    for (const ReportType &partial : partials) {
+        report.merge(partial);
+    };
+    return report;
+};
+
+/**
+ * @brief Configuración de un modelo del barrido de hiperparámetros: razón de aprendizaje y configuración de 
+ * entrenamiento (épocas, lote, semilla y paciencia).
+*/
+struct SweepConfig {
+    float learningRate;
+    TrainingConfig training;
+};
+
+/**
+ * @brief Resultado de un modelo del barrido: su configuración, su posición en la rejilla, el umbral de competencia 
+ * con más aciertos en el conjunto de evaluación (MIN_OUTPUT si empata), esos aciertos, los aciertos en entrenamiento 
+ * (con MIN_OUTPUT) y las épocas que recorrió la neurona que más tardó en detenerse.
+*/
+struct SweepResult {
+    SweepConfig config;
+    size_t model;
+    float threshold;
+    size_t hits;
+    size_t total;
+    size_t trainingHits;
+    int epochsRun;
+};
+
+/**
+ * @brief Función que convierte una lista separada por comas ("0.01,0.05,0.1") en un vector de números.
+ * 
+ * @param text Parámetro de tipo cadena de caracteres con la lista.
+ * 
+ * @return Vector de números de coma flotante.
+*/
+vector<float> parse_list(const string &text) {
+    vector<float> values;
+    istringstream stream(text);
+    string value;
+    while (getline(stream, value, ',')) {
+        if (!value.empty()) {
+            values.push_back(stof(value));
+        };
+    };
+    return values;
+};
+
+/**
+ * @brief Función que entrena a la vez todos los modelos de una rejilla de hiperparámetros en un solo proceso y los 
+ * ordena por aciertos en un conjunto de evaluación.
+ * 
+ * Todos los modelos comparten el mismo conjunto de datos, de solo lectura. Cada red crea sus pesos iniciales con su 
+ * propio generador (ver BasicNeuralNetwork(razón, semilla)) y cada neurona baraja con el suyo, así que el resultado 
+ * de un modelo no depende de los demás ni del número de hilos. El trabajo se reparte en tareas de una neurona de un 
+ * modelo: como cada perceptron se entrena de forma independiente, los hilos que terminan antes toman las neuronas 
+ * pendientes de cualquier modelo, aunque los modelos tengan épocas o lotes muy distintos. Después cada modelo se 
+ * evalúa con todos los umbrales a la vez (ver evaluate_network).
+ * 
+ * @param grid Parámetro de tipo vector de SweepConfig con los modelos a entrenar.
+ * @param dataset Parámetro de tipo conjunto de datos de entrenamiento (size(), glyph(i), label(i)).
+ * @param evaluation Parámetro de tipo conjunto de datos etiquetado con el que se ordenan los modelos.
+ * @param thresholds Parámetro de tipo vector de números de coma flotante con los umbrales de competencia a probar.
+ * @param threadsNumber Parámetro de tipo entero con el número de hilos (0 = todos los núcleos).
+ * @param networks Parámetro de tipo vector de redes donde quedan los modelos entrenados, en el orden de la rejilla.
+ * 
+ * @return Vector de SweepResult ordenado de mejor a peor (más aciertos en evaluación y luego en entrenamiento; si 
+ * empatan, en el orden de la rejilla).
+*/
+template <typename DatasetType, typename EvaluationType>
+vector<SweepResult> run_sweep(const vector<SweepConfig> &grid, const DatasetType &dataset, const EvaluationType &evaluation,
+                              const vector<float> &thresholds, int threadsNumber, vector<NeuralNetwork> &networks) {
+    networks.clear();
+    networks.reserve(grid.size());
+    for (const SweepConfig &config : grid) {
+        networks.emplace_back(config.learningRate, config.training.seed);
+    };
+
+    vector<std::array<TrainingReport, NeuralNetwork::CLASSES>> reports(grid.size());
+    vector<SweepResult> results(grid.size());
+    {
+        ThreadPool pool(threadsNumber);
+        for (size_t m = 0; m < grid.size(); m++) {
+            for (int c = 0; c < NeuralNetwork::CLASSES; c++) {
+                pool.submit([&, m, c]() {
+                    reports[m][c] = networks[m].perceptrons[c].training(dataset, c, grid[m].training);
+                });
+            };
+        };
+        pool.wait();
+
+        pool.parallel_for(grid.size(), 1, [&](size_t m, size_t) {
+            EvaluationReport report = evaluate_network(networks[m], evaluation, thresholds);
+            size_t best = report.best_threshold(std::find(thresholds.begin(), thresholds.end(), MIN_OUTPUT) - thresholds.begin());
+            SweepResult &result = results[m];
+            result = {grid[m], m, thresholds[best], report.hits(best), report.total(best), 0, 0};
+            for (size_t i = 0; i < dataset.size(); i++) {
+                result.trainingHits += networks[m].resolve(dataset.glyph(i)) == dataset.label(i);
+            };
+            for (const TrainingReport &training : reports[m]) {
+                result.epochsRun = std::max(result.epochsRun, static_cast<int>(training.epochs.size()));
+            };
+        });
+    }
+
+    std::stable_sort(results.begin(), results.end(), [](const SweepResult &a, const SweepResult &b) {
+        return a.hits != b.hits ? a.hits > b.hits : a.trainingHits > b.trainingHits;
+    });
+    return results;
+};
+
+/**
+ * @brief Función que reconoce todos los caracteres de un archivo repartiéndolos entre varios hilos. Cada hilo 
+ * reconoce y formatea un bloque de caracteres con la misma red fusionada (de solo lectura); luego los bloques se 
+ * escriben en el orden del archivo, un resultado por línea (vocal reconocida o "-" si no hay respuesta).
+ * 
+ * @param engine Parámetro de tipo red de reconocimiento por lotes (FusedNetwork o una red cuantizada).
+ * @param inputFilename Parámetro de tipo cadena de caracteres con el archivo de entrada.
+ * @param output Parámetro de tipo flujo de salida donde se escriben los resultados.
+ * @param threadsNumber Parámetro de tipo entero con el número de hilos (0 = todos los núcleos).
+*/
+template <typename Engine>
+void batch_recognition(const Engine &engine, const string &inputFilename, std::ostream &output, int threadsNumber) {
+    const size_t CHUNK_SIZE = 4096;
+    const char *vowels[] = {"a\n", "e\n", "i\n", "o\n", "u\n"};
+
+    vector<Glyph> glyphs = read_glyphs(inputFilename);
+    size_t chunksNumber = (glyphs.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    vector<string> chunkResults(chunksNumber);
+
+    ThreadPool pool(threadsNumber);
+    pool.parallel_for(glyphs.size(), CHUNK_SIZE, [&](size_t begin, size_t end) {
+        size_t count = end - begin;
+        vector<float> scores(count * Engine::CLASSES);
+        vector<int> answers(count);
+        engine.resolve_batch(glyphs.data() + begin, count, scores.data(), answers.data());
+
+        string &text = chunkResults[begin / CHUNK_SIZE];
+        text.reserve(count * 2);
+        for (int answer : answers) {
+            text += (answer >= 0 && answer < 5) ? vowels[answer] : "-\n";
+        };
+    });
+
+    for (const string &text : chunkResults) {
+        output << text;
+    };
+};
+
+/**
+ * @brief Clase GlyphStreamDecoder que separa caracteres de un flujo continuo de bytes, que puede llegar cortado en 
+ * cualquier punto. En modo texto cada caracter son ROWS_NUM filas de COLUMNS_NUM dígitos (con o sin espacios) y las 
+ * líneas sin dígitos se ignoran; en modo binario cada caracter es un bloque de Glyph::WORDS palabras de 32 bits 
+ * (little-endian), el mismo formato que Glyph guarda en memoria.
+*/
+class GlyphStreamDecoder {
+    public:
+        static constexpr size_t FRAME_SIZE = Glyph::WORDS * sizeof(uint32_t);
+
+        bool binary;
+        string pending;
+        Glyph current;
+        int row;
+
+        /**
+         * @brief Constructor de la clase GlyphStreamDecoder.
+         * 
+         * @param aBinary Parámetro de tipo booleano (verdadero para el formato binario).
+        */
+        GlyphStreamDecoder(bool aBinary) {
+            binary = aBinary;
+            row = 0;
+        };
+
+        /**
+         * @brief Método utilizado para procesar un bloque de bytes del flujo. Los caracteres completos se añaden al 
+         * vector; los bytes de un caracter incompleto se guardan hasta el siguiente bloque.
+         * 
+         * @param data Parámetro de tipo puntero a los bytes leídos.
+         * @param size Parámetro de tipo entero con el número de bytes.
+         * @param glyphs Parámetro de tipo vector de caracteres donde se añaden los caracteres completos.
+        */
+        void feed(const char *data, size_t size, vector<Glyph> &glyphs) {
+            pending.append(data, size);
+            size_t position = binary ? feed_binary(glyphs) : feed_text(glyphs);
+            pending.erase(0, position);
+        };
+
+        /**
+         * @brief Método utilizado al terminar el flujo: procesa la última fila si no acababa en salto de línea.
+         * 
+         * @param glyphs Parámetro de tipo vector de caracteres donde se añaden los caracteres completos.
+        */
+        void finish(vector<Glyph> &glyphs) {
+            if (!binary && !pending.empty()) {
+                feed("\n", 1, glyphs);
+            };
+        };
+
+        /**
+         * @brief Método utilizado para indicar si hay un caracter a medias (el flujo terminó antes de tiempo).
+        */
+        bool incomplete() const {
+            return row > 0 || !pending.empty();
+        };
+
+        size_t feed_binary(vector<Glyph> &glyphs) {
+            size_t position = 0;
+            for (; position + FRAME_SIZE <= pending.size(); position += FRAME_SIZE) {
+                Glyph glyph;
+                for (int w = 0; w < Glyph::WORDS; w++) {
+                    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(pending.data() + position) + w * 4;
+                    glyph.words[w] = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+                };
+                glyphs.push_back(glyph);
+            };
+            return position;
+        };
+
+        size_t feed_text(vector<Glyph> &glyphs) {
+            size_t position = 0;
+            size_t end;
+            while ((end = pending.find('\n', position)) != string::npos) {
+                int column = 0;
+                for (size_t c = position; c < end; c++) {
+                    char character = pending[c];
+                    if (character == '0' || character == '1') {
+                        if (column == COLUMNS_NUM) {
+                            throw std::runtime_error("Fila de caracter con más de " + to_string(COLUMNS_NUM) + " columnas");
+                        };
+                        current.set(row, column++, character == '1');
+                    };
+                };
+                position = end + 1;
+
+                // Líneas en blanco entre caracteres
+                if (column == 0) {
+                    continue;
+                };
+                if (column != COLUMNS_NUM) {
+                    throw std::runtime_error("Fila de caracter con " + to_string(column) + " columnas");
+                };
+                if (++row == ROWS_NUM) {
+                    glyphs.push_back(current);
+                    current.clear();
+                    row = 0;
+                };
+            };
+            return position;
+        };
+};
+
+// APRENDIZAJE EN LÍNEA
+
+/**
+ * Bandera que levanta la señal SIGHUP (ver main) para pedir que se vuelva a leer la base de conocimiento sin 
+ * detener el servicio. La atiende el hilo de entrenamiento de BasicOnlineModel. Es atómica (y sin cerrojos) porque 
+ * la señal puede llegar en cualquier hilo.
+*/
+std::atomic<bool> reloadRequested(false);
+
+/**
+ * @brief Clase BasicOnlineModel que sirve reconocimientos con una copia inmutable de la red mientras un hilo de 
+ * entrenamiento aplica correcciones a una copia propia (la red sombra) con la Regla Delta de la neurona.
+ * 
+ * Cada versión publicada es un Snapshot (red y red fusionada) que nunca se modifica. El hilo de entrenamiento 
+ * construye el siguiente aparte y lo publica cambiando un único puntero compartido (al estilo RCU): los lectores 
+ * que ya tenían el anterior terminan con él y se libera cuando lo suelta el último. Cada lector guarda su propio 
+ * puntero y solo lo renueva cuando cambia el número de generación (una lectura atómica), así que reconocer no 
+ * espera nunca a un entrenamiento ni a una recarga de la base.
+*/
+template <int Rows, int Columns, int Classes>
+class BasicOnlineModel {
+    public:
+        using NetworkType = BasicNeuralNetwork<Rows, Columns, Classes>;
+        using FusedType = BasicFusedNetwork<Rows, Columns, Classes>;
+        using GlyphType = BasicGlyph<Rows, Columns>;
+
+        struct Snapshot {
+            NetworkType network;
+            FusedType fused;
+            uint64_t generation;
+
+            Snapshot(const NetworkType &aNetwork, uint64_t aGeneration) : network(aNetwork), fused(aNetwork) {
+                generation = aGeneration;
+            };
+        };
+
+        using SnapshotPointer = std::shared_ptr<const Snapshot>;
+
+        struct Correction {
+            GlyphType glyph;
+            int label;
+        };
+
+        // Solo se lee y se escribe con std::atomic_load y std::atomic_store
+        SnapshotPointer current;
+        std::atomic<uint64_t> generation;
+        std::atomic<unsigned long long> applied;
+        // Solo la usa el hilo de entrenamiento
+        NetworkType shadow;
+        string baseFilename;
+        int maxSteps;
+        std::mutex mutex;
+        std::condition_variable pending;
+        std::deque<Correction> corrections;
+        bool stopping;
+        std::thread trainer;
+
+        /**
+         * @brief Constructor de la clase BasicOnlineModel. Publica la red dada como primera versión y arranca el 
+         * hilo de entrenamiento.
+         * 
+         * @param aNetwork Parámetro de tipo BasicNeuralNetwork con la base de conocimiento ya cargada.
+         * @param aBaseFilename Parámetro de tipo cadena de caracteres con la base que se vuelve a leer con SIGHUP.
+         * @param aMaxSteps Parámetro de tipo entero con el máximo de ajustes por corrección.
+        */
+        BasicOnlineModel(const NetworkType &aNetwork, const string &aBaseFilename, int aMaxSteps = 10)
+            : generation(0), applied(0), shadow(aNetwork) {
+            baseFilename = aBaseFilename;
+            maxSteps = std::max(aMaxSteps, 1);
+            stopping = false;
+            publish();
+            trainer = std::thread([this]() {
+                trainer_loop();
+            });
+        };
+
+        /**
+         * @brief Destructor de la clase BasicOnlineModel. Descarta las correcciones pendientes y espera al hilo de 
+         * entrenamiento.
+        */
+        ~BasicOnlineModel() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            };
+            pending.notify_all();
+            trainer.join();
+        };
+
+        BasicOnlineModel(const BasicOnlineModel &) = delete;
+        BasicOnlineModel &operator=(const BasicOnlineModel &) = delete;
+
+        /**
+         * @brief Método utilizado para obtener la versión publicada más reciente.
+        */
+        SnapshotPointer snapshot() const {
+            return std::atomic_load(&current);
+        };
+
+        /**
+         * @brief Método utilizado para renovar la versión que guarda un lector, solo si se publicó otra.
+         * 
+         * @param snapshot Parámetro de tipo SnapshotPointer con la versión del lector (puede estar vacío).
+         * 
+         * @return Verdadero si el lector pasó a una versión nueva.
+        */
+        bool refresh(SnapshotPointer &snapshot) const {
+            if (snapshot && snapshot->generation == generation.load(std::memory_order_acquire)) {
+                return false;
+            };
+            snapshot = std::atomic_load(&current);
+            return true;
+        };
+
+        /**
+         * @brief Método utilizado para encolar un caracter con la clase que debió reconocerse. No espera al 
+         * entrenamiento; la corrección se nota en la siguiente versión publicada.
+         * 
+         * @param glyph Parámetro de tipo GlyphType con el caracter.
+         * @param label Parámetro de tipo entero con la clase correcta (las clases fuera de rango se ignoran).
+        */
+        void correct(const GlyphType &glyph, int label) {
+            if (label < 0 || label >= Classes) {
+                return;
+            };
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                corrections.push_back({glyph, label});
+            };
+            pending.notify_one();
+        };
+
+        /**
+         * @brief Método utilizado por el hilo de entrenamiento: toma todas las correcciones pendientes, las aplica 
+         * a la red sombra y publica una sola versión nueva para todo el grupo. Mientras no hay correcciones 
+         * revisa cada 100 ms si se pidió recargar la base.
+        */
+        void trainer_loop() {
+            vector<Correction> batch;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    pending.wait_for(lock, std::chrono::milliseconds(100), [this]() {
+                        return stopping || !corrections.empty() || reloadRequested.load();
+                    });
+                    if (stopping) {
+                        return;
+                    };
+                    batch.assign(corrections.begin(), corrections.end());
+                    corrections.clear();
+                };
+
+                bool changed = false;
+                if (reloadRequested.exchange(false)) {
+                    try {
+                        shadow.import_knowledge_base(baseFilename);
+                        changed = true;
+                    } catch (const std::exception &error) {
+                        std::cerr << "no se pudo recargar " << baseFilename << ": " << error.what() << "\n";
+                    };
+                };
+                for (const Correction &correction : batch) {
+                    learn(correction);
+                    changed = true;
+                };
+                if (changed) {
+                    shadow.version++;
+                    publish();
+                };
+                applied.fetch_add(batch.size(), std::memory_order_relaxed);
+            };
+        };
+
+        /**
+         * @brief Método utilizado para aplicar la Regla Delta de cada neurona (adjust_weights y adjust_bias, con la 
+         * salida redondeada) hasta que la red sombra reconozca el caracter o se agoten los maxSteps ajustes.
+        */
+        void learn(const Correction &correction) {
+            for (int step = 0; step < maxSteps && shadow.resolve(correction.glyph) != correction.label; step++) {
+                for (int i = 0; i < Classes; i++) {
+                    int expected = static_cast<int>(i == correction.label);
+                    int output = static_cast<int>(round(shadow.perceptrons[i].activation_function(correction.glyph)));
+                    shadow.perceptrons[i].adjust_weights(correction.glyph, expected, output);
+                    shadow.perceptrons[i].adjust_bias(expected, output);
+                };
+                METRIC_ADD(COUNTER_TRAINING_UPDATES, 1);
+            };
+        };
+
+        /**
+         * @brief Método utilizado para publicar una copia de la red sombra como versión nueva. El puntero se cambia 
+         * antes que la generación, así que un lector que ve la generación nueva obtiene esa versión o una posterior.
+        */
+        void publish() {
+            uint64_t next = generation.load(std::memory_order_relaxed) + 1;
+            SnapshotPointer snapshot = std::make_shared<const Snapshot>(shadow, next);
+            std::atomic_store(&current, snapshot);
+            generation.store(next, std::memory_order_release);
+        };
+};
+
+using OnlineModel = BasicOnlineModel<ROWS_NUM, COLUMNS_NUM, CLASSES_NUM>;
+
+/**
+ * @brief Clase CorrectionReader que lee correcciones de un archivo con el formato de scan_labeled_glyphs 
+ * (caracteres precedidos de "// LETRA X") desde un hilo propio y las encola en el modelo. Si el archivo es una 
+ * tubería con nombre (FIFO), lo que manda cada escritor se reconoce cuando cierra y la tubería se vuelve a abrir, 
+ * así que puede alimentarse mientras el servicio esté en marcha. La tubería se abre sin bloqueo y se espera con 
+ * poll en intervalos de 100 ms, de modo que el destructor detiene el hilo y lo espera aunque nadie escriba.
+ * 
+ * Debe destruirse antes que el modelo que recibe las correcciones.
+*/
+class CorrectionReader {
+    public:
+        OnlineModel &model;
+        string filename;
+        bool fifo;
+        int descriptor;
+        std::atomic<bool> stopping;
+        std::thread reader;
+
+        /**
+         * @brief Constructor de la clase CorrectionReader. Abre el archivo y arranca el hilo de lectura.
+         * 
+         * @param aModel Parámetro de tipo OnlineModel que recibe las correcciones.
+         * @param aFilename Parámetro de tipo cadena de caracteres con el archivo o la tubería.
+        */
+        CorrectionReader(OnlineModel &aModel, const string &aFilename) : model(aModel), stopping(false) {
+            filename = aFilename;
+            fifo = false;
+            descriptor = -1;
+#if defined(PERCEPTRON_HAS_SOCKETS)
+            struct stat information;
+            fifo = stat(filename.c_str(), &information) == 0 && S_ISFIFO(information.st_mode);
+            descriptor = ::open(filename.c_str(), O_RDONLY | O_NONBLOCK);
+            if (descriptor < 0) {
+                throw std::runtime_error("No se pudo abrir el archivo de correcciones " + filename + ".");
+            };
+            reader = std::thread([this]() {
+                reader_loop();
+            });
+#else
+            // Sin poll no hay tuberías que esperar: el archivo se lee entero aquí mismo
+            PatternDataset dataset = scan_labeled_glyphs(filename);
+            feed(dataset);
+#endif
+        };
+
+        /**
+         * @brief Destructor de la clase CorrectionReader. Descarta lo que quede por leer y espera al hilo de 
+         * lectura.
+        */
+        ~CorrectionReader() {
+            stopping.store(true);
+            if (reader.joinable()) {
+                reader.join();
+            };
+#if defined(PERCEPTRON_HAS_SOCKETS)
+            if (descriptor >= 0) {
+                ::close(descriptor);
+            };
+#endif
+        };
+
+        CorrectionReader(const CorrectionReader &) = delete;
+        CorrectionReader &operator=(const CorrectionReader &) = delete;
+
+        /**
+         * @brief Método utilizado para encolar en el modelo los caracteres de un conjunto de datos.
         */
-        vector<int> competition(vector<float> results) {
-            vector<int> output = {0, 0, 0, 0, 0};
-            int index = -1;
-            float min_output = 0.15;
-            for (int i = 0; i < results.size(); i++) {
-                if (results[i] > min_output) {
-                    min_output = results[i];
-                    index = i;
+        void feed(const PatternDataset &dataset) {
+            for (size_t i = 0; i < dataset.size(); i++) {
+                model.correct(dataset.glyph(i), dataset.label(i));
+            };
+        };
+
+#if defined(PERCEPTRON_HAS_SOCKETS)
+        /**
+         * @brief Método utilizado por el hilo de lectura: acumula lo que llega hasta el fin del archivo (o hasta 
+         * que el escritor de la tubería cierra), lo reconoce y, si es una tubería, la vuelve a abrir.
+        */
+        void reader_loop() {
+            vector<char> text;
+            char chunk[16384];
+            while (!stopping.load()) {
+                struct pollfd input = {descriptor, POLLIN, 0};
+                int ready = poll(&input, 1, 100);
+                if (ready <= 0) {
+                    if (ready < 0 && errno != EINTR) {
+                        std::cerr << "no se pudieron leer las correcciones de " << filename << "\n";
+                        return;
+                    };
+                    continue;
+                };
+                long length = read(descriptor, chunk, sizeof(chunk));
+                if (length > 0) {
+                    text.insert(text.end(), chunk, chunk + length);
+                    continue;
+                };
+                if (length < 0) {
+                    if (errno != EAGAIN && errno != EINTR) {
+                        std::cerr << "no se pudieron leer las correcciones de " << filename << "\n";
+                        return;
+                    };
+                    continue;
+                };
+
+                feed(scan_labeled_glyphs(text.data(), text.data() + text.size()));
+                text.clear();
+                if (!fifo) {
+                    return;
+                };
+                // Tras cerrar el último escritor, poll avisaría siempre: se abre de nuevo para esperar al siguiente
+                ::close(descriptor);
+                descriptor = ::open(filename.c_str(), O_RDONLY | O_NONBLOCK);
+                if (descriptor < 0) {
+                    std::cerr << "no se pudo volver a abrir " << filename << "\n";
+                    return;
                 };
             };
+        };
+#endif
+};
 
-            if (index != -1) {
-                output[index] = 1;
-            }
-            return output;
+/**
+ * @brief Función que atiende la señal SIGHUP: pide al modelo en línea que vuelva a leer la base de conocimiento.
+*/
+void request_reload(int) {
+    reloadRequested.store(true);
+};
+
+/**
+ * @brief Configuración del modo servicio: formato de entrada, presupuesto de latencia y tamaño máximo de lote.
+*/
+struct ServiceConfig {
+    bool binary;
+    int latencyMicroseconds;
+    size_t maxBatch;
+};
+
+/**
+ * @brief Clase RecognitionService que lee caracteres de un descriptor (entrada estándar o conexión de socket) y 
+ * escribe una línea por caracter: "clase p0 p1 p2 p3 p4" (clase -1 si no hay respuesta; p son las salidas sigmoide 
+ * de cada neurona). Los caracteres se agrupan en micro-lotes: un lote se reconoce cuando se llena o cuando su 
+ * primer caracter lleva esperando latencyMicroseconds, lo que ocurra antes. Cada lote se reconoce con la versión 
+ * más reciente que haya publicado el modelo en línea.
+*/
+class RecognitionService {
+    public:
+        const OnlineModel &model;
+        OnlineModel::SnapshotPointer snapshot;
+        ServiceConfig config;
+        vector<Glyph> glyphs;
+        vector<float> scores;
+        vector<int> answers;
+        string text;
+        unsigned long long recognized;
+
+        /**
+         * @brief Constructor de la clase RecognitionService.
+         * 
+         * @param aModel Parámetro de tipo OnlineModel (se comparte; sus versiones son de solo lectura).
+         * @param aConfig Parámetro de tipo ServiceConfig.
+        */
+        RecognitionService(const OnlineModel &aModel, const ServiceConfig &aConfig) : model(aModel) {
+            config = aConfig;
+            if (config.maxBatch == 0) {
+                config.maxBatch = 1;
+            };
+            scores.resize(config.maxBatch * FusedNetwork::CLASSES);
+            answers.resize(config.maxBatch);
+            recognized = 0;
         };
 
         /**
-         * @brief Método utilizado para mostrar el vector de respuesta de la red neuronal en la consola.
+         * @brief Método utilizado para reconocer los caracteres pendientes (en lotes de maxBatch) y escribir sus 
+         * resultados.
          * 
-         * @param output Parámetro de tipo vector de enteros que representa la salida de la red neuronal.
+         * @param outputFd Parámetro de tipo entero con el descriptor de salida.
+         * 
+         * @return Verdadero si se pudo escribir todo (falso si el otro extremo cerró la conexión).
         */
-        string show_results(vector<int> output) {
-            vector<string> vowels = {"a", "e", "i", "o", "u"};
-            for (int i = 0; i < output.size(); i++) {
-                if (output[i] == 1) {
-                    return "Esto es una vocal " + vowels[i] + ".";
+        bool flush(int outputFd) {
+            text.clear();
+            char line[128];
+            model.refresh(snapshot);
+            const FusedNetwork &fusedNetwork = snapshot->fused;
+            for (size_t begin = 0; begin < glyphs.size(); begin += config.maxBatch) {
+                size_t count = std::min(config.maxBatch, glyphs.size() - begin);
+                fusedNetwork.resolve_batch(glyphs.data() + begin, count, scores.data(), answers.data());
+                for (size_t g = 0; g < count; g++) {
+                    const float *glyphScores = scores.data() + g * FusedNetwork::CLASSES;
+                    int length = std::snprintf(line, sizeof(line), "%d", answers[g]);
+                    for (int c = 0; c < FusedNetwork::CLASSES && length < static_cast<int>(sizeof(line)) - 16; c++) {
+                        length += std::snprintf(line + length, sizeof(line) - length, " %.6f", glyphScores[c]);
+                    };
+                    line[length++] = '\n';
+                    text.append(line, length);
                 };
             };
-            return "No reconozco esta letra.";
+            recognized += glyphs.size();
+            glyphs.clear();
+            return write_all(outputFd, text.data(), text.size());
         };
 
-        // KNOWLEDGE BASE
-
         /**
-         * @brief Método utilizado para importar la base de conocimiento de la red neuronal a tarvés de un .txt.
+         * @brief Método utilizado para atender un flujo hasta que se cierre (fin de archivo).
+         * 
+         * @param inputFd Parámetro de tipo entero con el descriptor de entrada.
+         * @param outputFd Parámetro de tipo entero con el descriptor de salida.
         */
-        void import_knowledge_base() {
-            FileManager fileManager("base.txt", "read");
-            for (Perceptron &perceptron : perceptrons) {
-                vector<vector<float>> weights = fileManager.parse_float_matrix();
-                float bias = fileManager.parse_float();
-                fileManager.line_break();
+        void serve(int inputFd, int outputFd) {
+            GlyphStreamDecoder decoder(config.binary);
+            vector<char> buffer(1 << 16);
+            auto batchStart = std::chrono::steady_clock::now();
+            auto budget = std::chrono::microseconds(config.latencyMicroseconds);
 
-                perceptron.set_weights(weights);
-                perceptron.set_bias(bias);
-            }
+            while (true) {
+                if (!glyphs.empty()) {
+                    auto waited = std::chrono::steady_clock::now() - batchStart;
+                    if (glyphs.size() >= config.maxBatch || waited >= budget || !wait_readable(inputFd, budget - waited)) {
+                        if (!flush(outputFd)) {
+                            return;
+                        };
+                        continue;
+                    };
+                };
+
+                long bytesRead = read_some(inputFd, buffer.data(), buffer.size());
+                if (bytesRead <= 0) {
+                    break;
+                };
+                bool wasEmpty = glyphs.empty();
+                decoder.feed(buffer.data(), bytesRead, glyphs);
+                if (wasEmpty && !glyphs.empty()) {
+                    batchStart = std::chrono::steady_clock::now();
+                };
+            };
+
+            decoder.finish(glyphs);
+            flush(outputFd);
+            if (decoder.incomplete()) {
+                throw std::runtime_error("El flujo de entrada terminó con un caracter incompleto");
+            };
         };
 
         /**
-         * @brief Método utilizado para exportar la base de conocimiento de la red neuronal a tarvés de un .txt.
+         * @brief Método utilizado para esperar datos en el descriptor como mucho el tiempo dado.
+         * 
+         * @return Verdadero si hay datos (o fin de archivo) por leer; falso si venció el tiempo o una señal 
+         * (SIGHUP) interrumpió la espera.
         */
-        void export_knowledge_base() {
-            FileManager fileManager("base.txt", "write");
+        static bool wait_readable(int inputFd, std::chrono::steady_clock::duration timeout) {
+#if defined(PERCEPTRON_HAS_SOCKETS)
+            struct pollfd descriptor = {inputFd, POLLIN, 0};
+            int milliseconds = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(timeout).count());
+            return poll(&descriptor, 1, std::max(milliseconds, 0)) > 0;
+#else
+            // Sin poll no se puede esperar con límite de tiempo: el lote se reconoce en cuanto se lee
+            (void) inputFd;
+            (void) timeout;
+            return false;
+#endif
+        };
 
-            for (Perceptron perceptron : perceptrons) {
-                string perceptron_info = perceptron.weights_to_string();
-                fileManager.write(perceptron_info);
+        static long read_some(int inputFd, char *data, size_t size) {
+#if defined(PERCEPTRON_HAS_SOCKETS)
+            // Una señal (SIGHUP) que interrumpe la lectura no es el fin del flujo
+            long bytesRead;
+            do {
+                bytesRead = read(inputFd, data, size);
+            } while (bytesRead < 0 && errno == EINTR);
+            return bytesRead;
+#else
+            (void) inputFd;
+            return static_cast<long>(std::fread(data, 1, size, stdin));
+#endif
+        };
+
+        static bool write_all(int outputFd, const char *data, size_t size) {
+#if defined(PERCEPTRON_HAS_SOCKETS)
+            while (size > 0) {
+                long written = write(outputFd, data, size);
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                };
+                if (written <= 0) {
+                    return false;
+                };
+                data += written;
+                size -= written;
             };
+            return true;
+#else
+            (void) outputFd;
+            bool done = std::fwrite(data, 1, size, stdout) == size;
+            return std::fflush(stdout) == 0 && done;
+#endif
         };
 };
 
 /**
- * @brief Función que toma los patrones (a través de unos .txt de ejemplos) utilizados para 
- * el entrenamiento de una red neuronal.
+ * @brief Función que atiende clientes por un socket Unix, uno tras otro, con la misma red ya cargada. Cada conexión 
+ * envía caracteres y recibe sus resultados por el mismo socket.
  * 
- * @param expectedValues Parámetro de tipo vector de vectores de enteros que representan los posibles
- * valores esperados de los patrones (vocales).
+ * @param model Parámetro de tipo OnlineModel con la red neuronal ya cargada.
+ * @param path Parámetro de tipo cadena de caracteres con la ruta del socket (se reemplaza si ya existe).
+ * @param config Parámetro de tipo ServiceConfig.
+*/
+void serve_socket(const OnlineModel &model, const string &path, const ServiceConfig &config) {
+#if defined(PERCEPTRON_HAS_SOCKETS)
+    struct sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Ruta de socket demasiado larga: " + path);
+    };
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path.c_str());
+    if (server < 0 || bind(server, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(server, 16) != 0) {
+        throw std::runtime_error("No se pudo escuchar en el socket " + path);
+    };
+    // Un cliente que cierra antes de leer sus resultados no debe terminar el servicio
+    signal(SIGPIPE, SIG_IGN);
+
+    while (true) {
+        int client = accept(server, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        };
+        RecognitionService service(model, config);
+        try {
+            service.serve(client, client);
+        } catch (const std::exception &error) {
+            string message = string("error: ") + error.what() + "\n";
+            RecognitionService::write_all(client, message.data(), message.size());
+        };
+        close(client);
+    };
+#else
+    (void) model;
+    (void) config;
+    throw std::runtime_error("Los sockets Unix no están disponibles en este sistema: " + path);
+#endif
+};
+
+/**
+ * @brief Función que escribe los totales de las métricas en JSON: contadores, tasa de rechazo, cronómetros (número 
+ * de mediciones, tiempo total y cubetas de 2^k ns) e histograma de la salida ganadora.
+ * 
+ * @param totals Parámetro de tipo MetricsTotals.
+ * @param uptime Parámetro de tipo número de coma flotante con los segundos desde el inicio del programa.
  * 
- * @return Vector de pares ordenados de matrices de enteros y vectores de enteros 
- * (entradas de la red y su salida esperada).
+ * @return Cadena de caracteres con el documento JSON.
 */
-vector<pair<vector<vector<int>>, vector<int>>> get_patterns(vector<vector<int>> expectedValues) {
-    string path = "patterns/";
-    vector<string> files = {"ejemplosA.txt", "ejemplosE.txt", "ejemplosI.txt", "ejemplosO.txt", "ejemplosU.txt"};
-    vector<pair<vector<vector<int>>, vector<int>>> patterns;
-    for (int i = 0; i < files.size(); i++) {
-        FileManager fileManager(path + files[i], "read");
-        for (int j = 0; j < PATTERNS_NUM; j++) {
-            vector<vector<int>> pattern = fileManager.parse_integer_matrix();
-            fileManager.line_break();
-            pair<vector<vector<int>>, vector<int>> pairIO = {pattern, expectedValues[i]};
-            patterns.push_back(pairIO);
+string metrics_to_json(const MetricsTotals &totals, double uptime) {
+    std::ostringstream text;
+    uint64_t recognized = totals.counters[COUNTER_GLYPHS_RECOGNIZED];
+    text << "{\"uptime_seconds\": " << uptime << ", \"counters\": {";
+    for (int c = 0; c < COUNTERS_NUM; c++) {
+        text << (c > 0 ? ", " : "") << "\"" << COUNTER_NAMES[c] << "\": " << totals.counters[c];
+    };
+    text << "}, \"reject_rate\": "
+         << (recognized > 0 ? static_cast<double>(totals.counters[COUNTER_GLYPHS_REJECTED]) / recognized : 0.0)
+         << ", \"timers\": {";
+    for (int t = 0; t < TIMERS_NUM; t++) {
+        text << (t > 0 ? ", " : "") << "\"" << TIMER_NAMES[t] << "\": {\"count\": " << totals.timerCounts[t]
+             << ", \"total_ns\": " << totals.timerNanoseconds[t] << ", \"log2_ns_buckets\": [";
+        for (int b = 0; b < LATENCY_BUCKETS; b++) {
+            text << (b > 0 ? ", " : "") << totals.timerBuckets[t][b];
         };
+        text << "]}";
     };
-    return patterns;
+    text << "}, \"score_buckets\": [";
+    for (int b = 0; b < SCORE_BUCKETS; b++) {
+        text << (b > 0 ? ", " : "") << totals.scoreBuckets[b];
+    };
+    text << "]}\n";
+    return text.str();
+};
+
+/**
+ * @brief Función que escribe los totales de las métricas en el formato de texto de Prometheus: un contador por 
+ * métrica, un histograma de duraciones por fase (etiqueta phase) y el histograma de la salida ganadora.
+ * 
+ * @param totals Parámetro de tipo MetricsTotals.
+ * @param uptime Parámetro de tipo número de coma flotante con los segundos desde el inicio del programa.
+ * 
+ * @return Cadena de caracteres con las métricas.
+*/
+string metrics_to_prometheus(const MetricsTotals &totals, double uptime) {
+    std::ostringstream text;
+    text << "# TYPE perceptron_uptime_seconds gauge\nperceptron_uptime_seconds " << uptime << "\n";
+    for (int c = 0; c < COUNTERS_NUM; c++) {
+        text << "# TYPE perceptron_" << COUNTER_NAMES[c] << "_total counter\n"
+             << "perceptron_" << COUNTER_NAMES[c] << "_total " << totals.counters[c] << "\n";
+    };
+
+    text << "# TYPE perceptron_duration_seconds histogram\n";
+    for (int t = 0; t < TIMERS_NUM; t++) {
+        uint64_t cumulative = 0;
+        for (int b = 0; b < LATENCY_BUCKETS - 1; b++) {
+            cumulative += totals.timerBuckets[t][b];
+            text << "perceptron_duration_seconds_bucket{phase=\"" << TIMER_NAMES[t] << "\",le=\""
+                 << std::ldexp(1e-9, b) << "\"} " << cumulative << "\n";
+        };
+        text << "perceptron_duration_seconds_bucket{phase=\"" << TIMER_NAMES[t] << "\",le=\"+Inf\"} "
+             << totals.timerCounts[t] << "\n"
+             << "perceptron_duration_seconds_sum{phase=\"" << TIMER_NAMES[t] << "\"} "
+             << totals.timerNanoseconds[t] * 1e-9 << "\n"
+             << "perceptron_duration_seconds_count{phase=\"" << TIMER_NAMES[t] << "\"} " << totals.timerCounts[t]
+             << "\n";
+    };
+
+    text << "# TYPE perceptron_winning_score histogram\n";
+    uint64_t cumulative = 0;
+    for (int b = 0; b < SCORE_BUCKETS; b++) {
+        char bound[16];
+        std::snprintf(bound, sizeof(bound), "%g", (b + 1.0) / SCORE_BUCKETS);
+        cumulative += totals.scoreBuckets[b];
+        text << "perceptron_winning_score_bucket{le=\"" << (b + 1 < SCORE_BUCKETS ? bound : "+Inf") << "\"} "
+             << cumulative << "\n";
+    };
+    text << "perceptron_winning_score_sum " << totals.scoreMicros * 1e-6 << "\n"
+         << "perceptron_winning_score_count " << cumulative << "\n";
+    return text.str();
+};
+
+/**
+ * @brief Clase MetricsExporter que escribe las métricas en un archivo cada intervalSeconds segundos, desde un hilo 
+ * propio, y una última vez al destruirse. Cada volcado se escribe en un archivo temporal y se renombra, así que 
+ * quien lo lea nunca ve un archivo a medias.
+*/
+class MetricsExporter {
+    public:
+        string filename;
+        bool prometheus;
+        int intervalSeconds;
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool stopping;
+        std::thread worker;
+
+        /**
+         * @brief Constructor de la clase MetricsExporter. Arranca el hilo de volcado.
+         * 
+         * @param aFilename Parámetro de tipo cadena de caracteres con el archivo de salida.
+         * @param aPrometheus Parámetro de tipo booleano (verdadero para Prometheus, falso para JSON).
+         * @param aIntervalSeconds Parámetro de tipo entero con los segundos entre volcados.
+        */
+        MetricsExporter(const string &aFilename, bool aPrometheus, int aIntervalSeconds) {
+            filename = aFilename;
+            prometheus = aPrometheus;
+            intervalSeconds = std::max(aIntervalSeconds, 1);
+            stopping = false;
+            worker = std::thread([this]() {
+                std::unique_lock<std::mutex> lock(mutex);
+                while (!wake.wait_for(lock, std::chrono::seconds(intervalSeconds), [this]() { return stopping; })) {
+                    dump();
+                };
+            });
+        };
+
+        /**
+         * @brief Destructor de la clase MetricsExporter. Detiene el hilo y escribe el último volcado.
+        */
+        ~MetricsExporter() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            };
+            wake.notify_all();
+            worker.join();
+            dump();
+        };
+
+        MetricsExporter(const MetricsExporter &) = delete;
+        MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+        /**
+         * @brief Método utilizado para escribir los totales actuales en el archivo.
+        */
+        void dump() {
+            MetricsTotals totals = metrics.totals();
+            string text = prometheus ? metrics_to_prometheus(totals, metrics.uptime())
+                                     : metrics_to_json(totals, metrics.uptime());
+            string temporary = filename + ".tmp";
+            {
+                std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+                file << text;
+                if (!file) {
+                    std::cerr << "no se pudieron escribir las métricas en " << temporary << "\n";
+                    return;
+                };
+            };
+            // En Windows rename no reemplaza un archivo existente
+            if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+                std::remove(filename.c_str());
+                std::rename(temporary.c_str(), filename.c_str());
+            };
+        };
 };
 
-int main(){
-    srand(static_cast<unsigned int>(std::time(nullptr)));
+/**
+ * @brief Función que interpreta los argumentos y ejecuta el modo pedido (ver main).
+ * 
+ * @return Código de salida del programa.
+*/
+int run(int argc, char *argv[]){
+    // Base de conocimiento a utilizar: ./perceptron_sigmoid_pair [--base archivo] [modo ...]
+    // Métricas (solo si se compiló con -DPERCEPTRON_METRICS): [--metrics archivo] [--metrics-format json|prometheus]
+    // [--metrics-interval segundos] antes del modo; se vuelcan periódicamente y al terminar.
+    string baseFilename = "base.txt";
+    string metricsFilename;
+    string metricsFormat = "json";
+    int metricsInterval = 10;
+    while (argc > 2) {
+        string option = argv[1];
+        if (option == "--base") {
+            baseFilename = argv[2];
+        } else if (option == "--metrics") {
+            metricsFilename = argv[2];
+        } else if (option == "--metrics-format") {
+            metricsFormat = argv[2];
+        } else if (option == "--metrics-interval") {
+            metricsInterval = stoi(argv[2]);
+        } else {
+            break;
+        };
+        argv += 2;
+        argc -= 2;
+    };
+    string mode = argc > 1 ? argv[1] : "";
+
+    std::unique_ptr<MetricsExporter> metricsExporter;
+    if (!metricsFilename.empty()) {
+#if !defined(PERCEPTRON_METRICS)
+        throw std::runtime_error("Las métricas no están compiladas: vuelva a compilar con -DPERCEPTRON_METRICS");
+#endif
+        if (metricsFormat != "json" && metricsFormat != "prometheus") {
+            throw std::runtime_error("Formato de métricas desconocido: " + metricsFormat);
+        };
+        metricsExporter.reset(new MetricsExporter(metricsFilename, metricsFormat == "prometheus", metricsInterval));
+    };
 
-    NeuralNetwork neuralNetwork(5, ITERATION_NUMBER);
+    NeuralNetwork neuralNetwork;
     
-    // Importa la base de conocimiento para el reconocimiento de vocales minusculas
-    neuralNetwork.import_knowledge_base();
+    // Importa la base de conocimiento (texto o binaria) para el reconocimiento de vocales minusculas
+    neuralNetwork.import_knowledge_base(baseFilename);
 
-    // Matriz de entrada con la vocal a analizar
-    FileManager fileManager("input.txt", "read");
+    // Arnés de medición: ./perceptron_sigmoid_pair --bench [--json] [factor] [segundos por fase]
+    if (mode == "--bench") {
+        bool json = argc > 2 && string(argv[2]) == "--json";
+        int first = json ? 3 : 2;
+        int factor = argc > first ? stoi(argv[first]) : 1000;
+        double minSeconds = argc > first + 1 ? std::stod(argv[first + 1]) : 0.5;
+        run_benchmarks(baseFilename, factor, minSeconds, json);
+        return 0;
+    };
 
-    cout << "===============================\n";
-    while (!fileManager.file.eof()) {
-        vector<vector<int>> inputMatrix = fileManager.parse_integer_matrix();
-        fileManager.line_break();
+    // Conversión de bases de conocimiento: ./perceptron_sigmoid_pair --convert entrada salida
+    // El formato de entrada se detecta solo; la salida es binaria si su nombre termina en .bin y de texto si no.
+    if (mode == "--convert" && argc > 3) {
+        NeuralNetwork network;
+        network.import_knowledge_base(argv[2]);
+        save_knowledge_base(network, argv[3]);
+        return 0;
+    };
+
+    // Entrenamiento: ./perceptron_sigmoid_pair --train salida [épocas] [lote (0 = completo)] [semilla] [opciones]
+    // Opciones: --patience n (épocas sin mejorar antes de parar), --validation fracción (parte de los patrones que
+    // se aparta para validar) y archivo=clase ... (sin archivos se entrena con patterns/ejemplosA..U.txt).
+    if (mode == "--train" && argc > 2) {
+        TrainingConfig config = {EPOCHS_NUM, BATCH_SIZE, RANDOM_STATE};
+        if (argc > 3) {
+            config.epochs = stoi(argv[3]);
+        };
+        if (argc > 4) {
+            config.batchSize = stoi(argv[4]);
+        };
+        if (argc > 5) {
+            config.seed = stoi(argv[5]);
+        };
+
+        float validationFraction = 0;
+        vector<pair<string, int>> files;
+        for (int a = 6; a < argc; a++) {
+            string option = argv[a];
+            if (option == "--patience" && a + 1 < argc) {
+                config.patience = stoi(argv[++a]);
+            } else if (option == "--validation" && a + 1 < argc) {
+                validationFraction = stof(argv[++a]);
+            } else {
+                size_t separator = option.rfind('=');
+                if (separator == string::npos) {
+                    throw std::runtime_error("Se esperaba archivo=clase: " + option);
+                };
+                files.emplace_back(option.substr(0, separator), stoi(option.substr(separator + 1)));
+            };
+        };
+
+        PatternDataset dataset;
+        if (!files.empty()) {
+            dataset.load_files(files);
+        } else {
+            dataset = get_pattern_dataset();
+        };
+        NeuralNetwork network;
+        std::array<TrainingReport, CLASSES_NUM> reports;
+        DatasetView shuffled(dataset);
+        mt19937 splitter(config.seed);
+        shuffled.shuffle(splitter);
+        size_t validationSize = static_cast<size_t>(dataset.size() * validationFraction);
+        DatasetView validation = shuffled.slice(0, validationSize);
+        if (validationSize > 0) {
+            reports = network.training(shuffled.slice(validationSize, dataset.size()), config, &validation);
+        } else {
+            reports = network.training(dataset, config);
+        };
+
+        // Error y pérdida por época; una neurona que ya se detuvo mantiene los valores de su última época
+        size_t epochsRun = 0;
+        for (const TrainingReport &report : reports) {
+            epochsRun = std::max(epochsRun, report.epochs.size());
+        };
+        for (size_t epoch = 0; epoch < epochsRun; epoch++) {
+            int errors = 0;
+            int validationErrors = 0;
+            float loss = 0;
+            for (const TrainingReport &report : reports) {
+                const EpochStats &stats = report.epochs[std::min(epoch, report.epochs.size() - 1)];
+                errors += stats.errors;
+                validationErrors += stats.validationErrors;
+                loss += stats.loss / CLASSES_NUM;
+            };
+            cout << "época " << epoch + 1 << ": errores " << errors << ", pérdida " << loss;
+            if (validationSize > 0) {
+                cout << ", errores de validación " << validationErrors;
+            };
+            cout << "\n";
+        };
+        const char *vowels[] = {"a", "e", "i", "o", "u"};
+        for (int c = 0; c < CLASSES_NUM; c++) {
+            cout << "neurona " << vowels[c] << ": " << reports[c].epochs.size() << " épocas"
+                 << (reports[c].converged ? " (convergió)" : "") << ", pesos de la época " << reports[c].bestEpoch << "\n";
+        };
+
+        int hits = 0;
+        for (size_t i = 0; i < dataset.size(); i++) {
+            hits += network.resolve(dataset.glyph(i)) == dataset.label(i);
+        };
+        cout << "aciertos en entrenamiento: " << hits << "/" << dataset.size() << "\n";
+        if (validationSize > 0) {
+            int validationHits = 0;
+            for (size_t i = 0; i < validation.size(); i++) {
+                validationHits += network.resolve(validation.glyph(i)) == validation.label(i);
+            };
+            cout << "aciertos en validación: " << validationHits << "/" << validation.size() << "\n";
+        };
+        save_knowledge_base(network, argv[2]);
+        return 0;
+    };
+
+    // Entrenamiento con aumentación al vuelo:
+    // ./perceptron_sigmoid_pair --train-augmented salida [muestras] [lote] [semilla] [hilos]
+    if (mode == "--train-augmented" && argc > 2) {
+        size_t samples = argc > 3 ? std::stoul(argv[3]) : 30000;
+        int batchSize = argc > 4 ? stoi(argv[4]) : BATCH_SIZE;
+        unsigned int seed = argc > 5 ? stoi(argv[5]) : RANDOM_STATE;
+        int threadsNumber = argc > 6 ? stoi(argv[6]) : 0;
+        AugmentationConfig augmentation = {1, 10, 0.15f, 0.1f, 2};
+
+        vector<Pattern> patterns = get_patterns(get_expected_values());
+        NeuralNetwork network;
+        unsigned long long stalls;
+        {
+            AugmentationStream<Pattern> stream(patterns, augmentation, samples, 4096, threadsNumber, seed);
+            network.training_stream(stream, batchSize);
+            stalls = stream.stalls;
+        };
+
+        int hits = 0;
+        for (const Pattern &pattern : patterns) {
+            int answer = network.resolve(pattern.first);
+            hits += answer >= 0 && pattern.second[answer] == 1;
+        };
+        cout << "aciertos en entrenamiento: " << hits << "/" << patterns.size() << " (" << samples
+             << " muestras aumentadas, " << stalls << " esperas del entrenamiento)\n";
+        save_knowledge_base(network, argv[2]);
+        return 0;
+    };
+
+    // Medición del parser: ./perceptron_sigmoid_pair --bench-parse [factor]
+    if (mode == "--bench-parse") {
+        benchmark_parsing(argc > 2 ? stoi(argv[2]) : 100);
+        return 0;
+    };
+
+    // Modo por lotes: ./perceptron_sigmoid_pair --batch entrada.txt [salida.txt] [hilos]
+    // Con --batch-int8 o --batch-int16 se reconoce con la red cuantizada correspondiente; con --batch-cached, con la
+    // red en coma flotante y una tabla de resultados (los aciertos y fallos de la tabla se informan por stderr).
+    if ((mode == "--batch" || mode == "--batch-int8" || mode == "--batch-int16" || mode == "--batch-cached") && argc > 2) {
+        int threadsNumber = argc > 4 ? stoi(argv[4]) : 0;
+        std::ofstream outputFile;
+        if (argc > 3) {
+            outputFile.open(argv[3]);
+        };
+        std::ostream &output = argc > 3 ? outputFile : cout;
+        if (mode == "--batch-int8") {
+            batch_recognition(QuantizedNetwork8(neuralNetwork), argv[2], output, threadsNumber);
+        } else if (mode == "--batch-int16") {
+            batch_recognition(QuantizedNetwork16(neuralNetwork), argv[2], output, threadsNumber);
+        } else if (mode == "--batch-cached") {
+            RecognitionCache cache(neuralNetwork);
+            batch_recognition(cache, argv[2], output, threadsNumber);
+            std::cerr << "tabla de resultados: " << cache.hits() << " aciertos, " << cache.misses() << " fallos\n";
+        } else {
+            batch_recognition(FusedNetwork(neuralNetwork), argv[2], output, threadsNumber);
+        };
+        return 0;
+    };
+
+    // Red multicapa: ./perceptron_sigmoid_pair --train-mlp salida.bin [ocultas] [épocas] [lote] [razón] [semilla]
+    // Con 0 neuronas ocultas se entrena la red de una capa con retropropagación.
+    if (mode == "--train-mlp" && argc > 2) {
+        int hiddenNumber = argc > 3 ? stoi(argv[3]) : 16;
+        TrainingConfig config = {argc > 4 ? stoi(argv[4]) : 200, argc > 5 ? stoi(argv[5]) : 10,
+                                 static_cast<unsigned int>(argc > 7 ? stoi(argv[7]) : RANDOM_STATE)};
+        float learningRate = argc > 6 ? stof(argv[6]) : 0.5f;
+
+        PatternDataset dataset = get_pattern_dataset();
+        LayeredNetwork network(hiddenNumber, config.seed);
+        network.training(dataset, config, learningRate);
+
+        PatternDataset examples = scan_labeled_glyphs("test/asking_examples.txt");
+        for (const PatternDataset *evaluated : {&dataset, &examples}) {
+            int hits = 0;
+            for (size_t i = 0; i < evaluated->size(); i++) {
+                hits += network.resolve(evaluated->glyph(i)) == evaluated->label(i);
+            };
+            cout << (evaluated == &dataset ? "aciertos en entrenamiento: " : "aciertos en test/asking_examples.txt: ")
+                 << hits << "/" << evaluated->size() << "\n";
+        };
+        network.save(argv[2]);
+        return 0;
+    };
+
+    // Reconocimiento por lotes con una red multicapa: ./perceptron_sigmoid_pair --batch-mlp base.bin entrada [salida] [hilos]
+    if (mode == "--batch-mlp" && argc > 3) {
+        LayeredNetwork network(argv[2]);
+        int threadsNumber = argc > 5 ? stoi(argv[5]) : 0;
+        if (argc > 4) {
+            std::ofstream outputFile(argv[4]);
+            batch_recognition(network, argv[3], outputFile, threadsNumber);
+        } else {
+            batch_recognition(network, argv[3], cout, threadsNumber);
+        };
+        return 0;
+    };
+
+    // Barrido de hiperparámetros: ./perceptron_sigmoid_pair --sweep salida [--rates l] [--epochs l] [--batch l]
+    // [--seeds l] [--patience n] [--threads n] [--set archivo] [archivo=clase ...]
+    // Cada l es una lista separada por comas; se entrena un modelo por cada combinación y se guarda el mejor en salida.
+    if (mode == "--sweep" && argc > 2) {
+        vector<float> rates = {0.01f, 0.05f, 0.1f, 0.2f};
+        vector<float> epochs = {EPOCHS_NUM, 50};
+        vector<float> batches = {BATCH_SIZE, 10};
+        vector<float> seeds = {RANDOM_STATE, 7};
+        int patience = 0;
+        int threadsNumber = 0;
+        string evaluationFilename = "test/asking_examples.txt";
+        vector<pair<string, int>> files;
+        for (int a = 3; a < argc; a++) {
+            string option = argv[a];
+            if (option == "--rates" && a + 1 < argc) {
+                rates = parse_list(argv[++a]);
+            } else if (option == "--epochs" && a + 1 < argc) {
+                epochs = parse_list(argv[++a]);
+            } else if (option == "--batch" && a + 1 < argc) {
+                batches = parse_list(argv[++a]);
+            } else if (option == "--seeds" && a + 1 < argc) {
+                seeds = parse_list(argv[++a]);
+            } else if (option == "--patience" && a + 1 < argc) {
+                patience = stoi(argv[++a]);
+            } else if (option == "--threads" && a + 1 < argc) {
+                threadsNumber = stoi(argv[++a]);
+            } else if (option == "--set" && a + 1 < argc) {
+                evaluationFilename = argv[++a];
+            } else {
+                size_t separator = option.rfind('=');
+                if (separator == string::npos) {
+                    throw std::runtime_error("Opción desconocida en el barrido: " + option);
+                };
+                files.emplace_back(option.substr(0, separator), stoi(option.substr(separator + 1)));
+            };
+        };
 
+        vector<SweepConfig> grid;
+        for (float rate : rates) {
+            for (float epochsNumber : epochs) {
+                for (float batchSize : batches) {
+                    for (float seed : seeds) {
+                        grid.push_back({rate, {static_cast<int>(epochsNumber), static_cast<int>(batchSize),
+                                               static_cast<unsigned int>(seed), patience}});
+                    };
+                };
+            };
+        };
+
+        PatternDataset dataset;
+        if (!files.empty()) {
+            dataset.load_files(files);
+        } else {
+            dataset = get_pattern_dataset();
+        };
+        PatternDataset evaluation = scan_labeled_glyphs(evaluationFilename);
+        vector<float> thresholds;
+        for (int k = 0; k < 20; k++) {
+            thresholds.push_back(k / 20.0f);
+        };
+
+        vector<NeuralNetwork> networks;
+        vector<SweepResult> results = run_sweep(grid, dataset, evaluation, thresholds, threadsNumber, networks);
+
+        cout << grid.size() << " modelos, evaluados con " << evaluationFilename << "\n";
+        cout << "puesto   razón  épocas  lote  semilla  umbral  aciertos  entrenamiento  épocas recorridas\n";
+        char line[160];
+        for (size_t r = 0; r < results.size(); r++) {
+            const SweepResult &result = results[r];
+            string hits = to_string(result.hits) + "/" + to_string(result.total);
+            string trainingHits = to_string(result.trainingHits) + "/" + to_string(dataset.size());
+            std::snprintf(line, sizeof(line), "%6zu  %6g  %6d  %4d  %7u  %6.2f  %8s  %13s  %17d\n", r + 1,
+                          result.config.learningRate, result.config.training.epochs, result.config.training.batchSize,
+                          result.config.training.seed, result.threshold, hits.c_str(), trainingHits.c_str(),
+                          result.epochsRun);
+            cout << line;
+        };
+        if (!results.empty()) {
+            save_knowledge_base(networks[results.front().model], argv[2]);
+            cout << "mejor modelo guardado en " << argv[2] << "\n";
+        };
+        return 0;
+    };
+
+    // Evaluación: ./perceptron_sigmoid_pair --evaluate [--threads n] [--set archivo] [archivo=clase ...] [base ...]
+    // --set carga un archivo con líneas "// LETRA X" (por defecto test/asking_examples.txt); archivo=clase carga un
+    // archivo cuyos caracteres son todos de esa clase. Sin bases se evalúa la base de --base (base.txt).
+    if (mode == "--evaluate") {
+        int threadsNumber = 0;
+        vector<string> bases;
+        vector<string> sets;
+        PatternDataset dataset;
+        for (int a = 2; a < argc; a++) {
+            string option = argv[a];
+            if (option == "--threads" && a + 1 < argc) {
+                threadsNumber = stoi(argv[++a]);
+            } else if (option == "--set" && a + 1 < argc) {
+                sets.push_back(argv[++a]);
+            } else if (option.rfind('=') != string::npos) {
+                size_t separator = option.rfind('=');
+                dataset.load_file(option.substr(0, separator), stoi(option.substr(separator + 1)));
+            } else {
+                bases.push_back(option);
+            };
+        };
+        if (sets.empty() && dataset.size() == 0) {
+            sets.push_back("test/asking_examples.txt");
+        };
+        for (const string &set : sets) {
+            PatternDataset scanned = scan_labeled_glyphs(set);
+            for (size_t i = 0; i < scanned.size(); i++) {
+                dataset.add(scanned.glyph(i), scanned.label(i));
+            };
+        };
+        if (bases.empty()) {
+            bases.push_back(baseFilename);
+        };
+
+        // Umbrales de 0.00 a 0.95 cada 0.05 (incluye MIN_OUTPUT = 0.15)
+        vector<float> thresholds;
+        for (int k = 0; k < 20; k++) {
+            thresholds.push_back(k / 20.0f);
+        };
+        size_t defaultThreshold = std::find(thresholds.begin(), thresholds.end(), MIN_OUTPUT) - thresholds.begin();
+
+        vector<EvaluationReport> reports;
+        for (const string &base : bases) {
+            NeuralNetwork network;
+            network.import_knowledge_base(base);
+            reports.push_back(evaluate_network(network, dataset, thresholds, threadsNumber));
+            cout << "== " << base << " ==\n";
+            reports.back().print(cout, defaultThreshold);
+            cout << "\n";
+        };
+
+        if (bases.size() > 1) {
+            cout << "base: aciertos con umbral " << MIN_OUTPUT << " / mejor umbral\n";
+            for (size_t b = 0; b < bases.size(); b++) {
+                const EvaluationReport &report = reports[b];
+                size_t best = report.best_threshold(defaultThreshold);
+                cout << bases[b] << ": " << report.hits(defaultThreshold) << "/" << report.total(defaultThreshold)
+                     << " / " << report.hits(best) << " con umbral " << report.thresholds[best] << "\n";
+            };
+        };
+        return 0;
+    };
+
+    // Validación de las redes cuantizadas: ./perceptron_sigmoid_pair --check-quantized [archivo (test/test.txt)]
+    if (mode == "--check-quantized") {
+        string filename = argc > 2 ? argv[2] : "test/test.txt";
+        vector<Glyph> glyphs = scan_glyphs(filename);
+        if (glyphs.empty()) {
+            throw std::runtime_error("No hay caracteres que validar en " + filename + ".");
+        };
+        bool valid = validate_quantized(neuralNetwork, QuantizedNetwork16(neuralNetwork), glyphs, "int16");
+        valid = validate_quantized(neuralNetwork, QuantizedNetwork8(neuralNetwork), glyphs, "int8") && valid;
+        return valid ? 0 : 1;
+    };
+
+    // Imágenes: ./perceptron_sigmoid_pair --images [--threads n] [--threshold gris] [--coverage f] [--min-ink n]
+    // [--matrices] imagen.pgm ...
+    // Reconoce los caracteres de cada imagen (una línea por imagen); con --matrices escribe en cambio sus matrices
+    // con el formato de input.txt.
+    if (mode == "--images") {
+        IngestionConfig config = {-1, 0.3f, 8};
+        int threadsNumber = 0;
+        bool matrices = false;
+        vector<string> images;
+        for (int a = 2; a < argc; a++) {
+            string option = argv[a];
+            if (option == "--threads" && a + 1 < argc) {
+                threadsNumber = stoi(argv[++a]);
+            } else if (option == "--threshold" && a + 1 < argc) {
+                config.threshold = stoi(argv[++a]);
+            } else if (option == "--coverage" && a + 1 < argc) {
+                config.coverage = stof(argv[++a]);
+            } else if (option == "--min-ink" && a + 1 < argc) {
+                config.minInk = stoi(argv[++a]);
+            } else if (option == "--matrices") {
+                matrices = true;
+            } else {
+                images.push_back(option);
+            };
+        };
+
+        // Cada tarea decodifica un bloque de imágenes y reconoce todos sus caracteres en un solo lote
+        const size_t CHUNK_SIZE = 16;
+        FusedNetwork fusedNetwork(neuralNetwork);
+        vector<string> chunkResults((images.size() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+        vector<string> chunkErrors(chunkResults.size());
+        ThreadPool pool(threadsNumber);
+        pool.parallel_for(images.size(), CHUNK_SIZE, [&](size_t begin, size_t end) {
+            vector<Glyph> glyphs;
+            vector<size_t> counts;
+            vector<string> errors;
+            for (size_t i = begin; i < end; i++) {
+                try {
+                    counts.push_back(extract_glyphs(GrayImage(images[i]), config, glyphs));
+                    errors.emplace_back();
+                } catch (const std::exception &error) {
+                    counts.push_back(0);
+                    errors.push_back(error.what());
+                };
+            };
+            vector<float> scores(glyphs.size() * FusedNetwork::CLASSES);
+            vector<int> answers(glyphs.size());
+            fusedNetwork.resolve_batch(glyphs.data(), glyphs.size(), scores.data(), answers.data());
+
+            string &text = chunkResults[begin / CHUNK_SIZE];
+            const char *vowels[] = {"a", "e", "i", "o", "u"};
+            size_t g = 0;
+            for (size_t i = 0; i < counts.size(); i++) {
+                if (!errors[i].empty()) {
+                    chunkErrors[begin / CHUNK_SIZE] += images[begin + i] + ": " + errors[i] + "\n";
+                    continue;
+                };
+                if (!matrices) {
+                    text += images[begin + i] + ":";
+                };
+                for (size_t k = 0; k < counts[i]; k++, g++) {
+                    if (!matrices) {
+                        text += answers[g] >= 0 && answers[g] < 5 ? string(" ") + vowels[answers[g]] : " -";
+                        continue;
+                    };
+                    for (int r = 0; r < ROWS_NUM; r++) {
+                        for (int c = 0; c < COLUMNS_NUM; c++) {
+                            text += glyphs[g].get(r, c) ? "1 " : "0 ";
+                        };
+                        text += "\n";
+                    };
+                    text += "\n";
+                };
+                if (!matrices) {
+                    text += "\n";
+                };
+            };
+        });
+
+        bool failed = false;
+        for (size_t k = 0; k < chunkResults.size(); k++) {
+            cout << chunkResults[k];
+            std::cerr << chunkErrors[k];
+            failed = failed || !chunkErrors[k].empty();
+        };
+        return failed ? 1 : 0;
+    };
+
+    // Modo servicio: ./perceptron_sigmoid_pair --serve [--binary] [--socket ruta] [--latency us] [--max-batch n]
+    // [--learn ruta]
+    // Lee caracteres de la entrada estándar (o de cada conexión al socket) hasta el fin del flujo. Con --learn, los
+    // caracteres etiquetados ("// LETRA X") que lleguen por ruta (archivo o FIFO) corrigen la red sin detener el
+    // servicio; la señal SIGHUP vuelve a leer la base de conocimiento.
+    if (mode == "--serve") {
+        ServiceConfig config = {false, 2000, 256};
+        string socketPath;
+        string learnPath;
+        for (int a = 2; a < argc; a++) {
+            string option = argv[a];
+            if (option == "--binary") {
+                config.binary = true;
+            } else if (option == "--socket" && a + 1 < argc) {
+                socketPath = argv[++a];
+            } else if (option == "--latency" && a + 1 < argc) {
+                config.latencyMicroseconds = stoi(argv[++a]);
+            } else if (option == "--max-batch" && a + 1 < argc) {
+                config.maxBatch = stoi(argv[++a]);
+            } else if (option == "--learn" && a + 1 < argc) {
+                learnPath = argv[++a];
+            } else {
+                throw std::runtime_error("Opción desconocida en modo servicio: " + option);
+            };
+        };
+
+        OnlineModel model(neuralNetwork, baseFilename);
+#if defined(PERCEPTRON_HAS_SOCKETS)
+        signal(SIGHUP, request_reload);
+#endif
+        // Se declara después del modelo para que su hilo termine antes de que el modelo se destruya
+        std::unique_ptr<CorrectionReader> corrections;
+        if (!learnPath.empty()) {
+            corrections.reset(new CorrectionReader(model, learnPath));
+        };
+        if (!socketPath.empty()) {
+            serve_socket(model, socketPath, config);
+        } else {
+            RecognitionService service(model, config);
+            try {
+                service.serve(0, 1);
+            } catch (const std::exception &error) {
+                // Los resultados de los caracteres anteriores al error ya se escribieron
+                std::cerr << "error: " << error.what() << "\n";
+                return 1;
+            };
+        };
+        return 0;
+    };
+
+    // Matrices de entrada con las vocales a analizar, reconocidas en un solo lote
+    vector<Glyph> glyphs = read_glyphs("input.txt");
+    FusedNetwork fusedNetwork(neuralNetwork);
+    vector<float> scores(glyphs.size() * FusedNetwork::CLASSES);
+    vector<int> answers(glyphs.size());
+    fusedNetwork.resolve_batch(glyphs.data(), glyphs.size(), scores.data(), answers.data());
+
+    cout << "===============================\n";
+    for (size_t g = 0; g < glyphs.size(); g++) {
         // Resultados
         cout << "Jimmy Neuron necesita pensar...\n";
-        vector<int> output = neuralNetwork.resolve(inputMatrix);
-        string neuralResult = neuralNetwork.show_results(output);
+        string neuralResult = neuralNetwork.show_results(answers[g]);
         cout << neuralResult << "\n===============================\n";
     };
 
     return 0;
+};
+
+int main(int argc, char *argv[]){
+    // Cualquier error (archivo ilegible, opción inválida, entrada mal formada) se informa por stderr y termina con 1
+    try {
+        return run(argc, argv);
+    } catch (const std::exception &error) {
+        std::cerr << "error: " << error.what() << "\n";
+        return 1;
+    };
 };
\ No newline at end of file